@@ -488,7 +488,7 @@ namespace toy
 		Renderer& renderer = *Caption::s_renderer;
 
 		Wedge& options = tooldock.addDock("Options").m_body;
-		options.emplace<InputText>("Debug draw filter", "", [&](string value) { renderer.m_debugDrawFilter = value; });
+		options.emplace<InputText>("Debug draw filter", "", [&](string value) { renderer.m_debugDrawFilter = StyleRegistry::id(value); });
 		options.emplace<InputBool>("Debug draw Frame", false, [&](bool on) { renderer.m_debugDrawFrameRect = on; });
 		options.emplace<InputBool>("Debug draw Padding", false, [&](bool on) { renderer.m_debugDrawPaddedRect = on; });
 		options.emplace<InputBool>("Debug draw Content", false, [&](bool on) { renderer.m_debugDrawContentRect = on; });
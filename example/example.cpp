@@ -28,6 +28,63 @@
 	#define TOYUI_RESOURCE_PATH "../../data/"
 #endif
 
+#include <cstdlib>
+#include <new>
+
+// counts every heap allocation of the program, so that --check-allocations can tell whether a code path touches the heap
+static size_t g_allocations = 0;
+
+void* operator new(size_t size)
+{
+	++g_allocations;
+	if(void* memory = malloc(size ? size : 1))
+		return memory;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+// hovers, presses and releases a row of widgets : once warmed up, dispatching the same sequence again must not allocate
+bool checkMouseAllocations(toy::UiWindow& uiWindow)
+{
+	toy::Wedge& sheet = uiWindow.m_rootSheet->emplace<toy::Wedge>();
+	std::vector<toy::Widget*> targets;
+	for(int i = 0; i < 8; ++i)
+	{
+		targets.push_back(&sheet.emplace<toy::Label>("Label " + toy::toString(i)));
+		targets.push_back(&sheet.emplace<toy::Button>("Button " + toy::toString(i), [](toy::Widget&) {}));
+	}
+
+	uiWindow.nextFrame();
+
+	std::vector<toy::DimFloat> points;
+	for(toy::Widget* target : targets)
+		points.push_back(target->frame().derivePosition(target->frame().m_size * toy::DimFloat(0.5f, 0.5f)));
+	points.push_back({ 0.f, 0.f });
+
+	toy::Mouse& mouse = uiWindow.m_rootSheet->m_mouse;
+	auto dispatch = [&] {
+		for(toy::DimFloat& point : points)
+		{
+			mouse.dispatchMouseMoved(point);
+			mouse.dispatchMousePressed(point, toy::LEFT_BUTTON);
+			mouse.dispatchMouseReleased(point, toy::LEFT_BUTTON);
+		}
+	};
+
+	dispatch();
+
+	size_t allocations = g_allocations;
+	dispatch();
+	allocations = g_allocations - allocations;
+
+	printf("Mouse dispatch of %i events: %i allocations\n", int(points.size() * 3), int(allocations));
+	return allocations == 0;
+}
+
 int main(int argc, char *argv[])
 {
 #ifdef TOY_PLATFORM_EMSCRIPTEN
@@ -45,6 +102,15 @@ int main(int argc, char *argv[])
 
 	toy::UiWindow uiwindow(renderSystem, "kiUi demo", 1200, 800, false);
 
+	std::string mode = argc > 1 ? argv[1] : "";
+
+	// --compile-styles <sheet.yml> <output> : compiles a style sheet offline, to be loaded with set_compiled_style_sheet
+	if(mode == "--compile-styles" && argc > 3)
+		return toy::compile_style_sheet(*uiwindow.m_styler, argv[2], argv[3]) ? 0 : 1;
+
+	if(mode == "--check-allocations")
+		return checkMouseAllocations(uiwindow) ? 0 : 1;
+
 	toy::Wedge& rootSheet = *uiwindow.m_rootSheet;
 	createUiTest(rootSheet);
 
@@ -18,6 +18,9 @@
 #include <nanovg.h>
 
 #include <cmath>
+#include <cstring>
+#include <cfloat>
+#include <algorithm>
 
 namespace toy
 {
@@ -26,6 +29,20 @@ namespace toy
 		return (v > mx) ? mx : (v < mn) ? mn : v;
 	}
 
+	// rasterized glyph sizes are snapped to multiples of this step when drawing under a scale
+	const float c_glyphSizeStep = 0.5f;
+	// nanovg never rasterizes glyphs above this scale, it stretches them instead
+	const float c_glyphMaxScale = 4.f;
+	// kerning pairs are measured the first time they are met
+	const float c_unmeasured = FLT_MAX;
+
+	inline uint64_t fontKey(int face, float size)
+	{
+		uint32_t sizeBits;
+		memcpy(&sizeBits, &size, sizeof(float));
+		return uint64_t(uint32_t(face)) << 32 | sizeBits;
+	}
+
 	NVGcolor nvgColour(const Colour& colour)
 	{
 		return nvgRGBAf(colour.m_r, colour.m_g, colour.m_b, colour.m_a);
@@ -43,6 +60,12 @@ namespace toy
 	NanoRenderer::NanoRenderer(const string& resourcePath)
 		: Renderer(resourcePath)
 		, m_ctx(nullptr)
+		, m_textStates{ { -1, 0.f, -1 } }
+		, m_advanceKey(0)
+		, m_advanceTable(nullptr)
+	{}
+
+	NanoRenderer::~NanoRenderer()
 	{}
 
 	object_ptr<RenderTarget> NanoRenderer::createRenderTarget(Layer& layer)
@@ -54,9 +77,12 @@ namespace toy
 	{
 		if(m_null) return;
 		string fontPath = m_resourcePath + "interface/fonts/DejaVuSans.ttf";
-		nvgCreateFont(m_ctx, "dejavu", fontPath.c_str());
+		m_fontFaces["dejavu"] = nvgCreateFont(m_ctx, "dejavu", fontPath.c_str());
 		nvgFontSize(m_ctx, 14.0f);
 		nvgFontFace(m_ctx, "dejavu");
+		m_lineHeights.clear();
+		m_advanceTables.clear();
+		m_advanceTable = nullptr;
 	}
 
 	void NanoRenderer::loadImageRGBA(Image& image, const unsigned char* data)
@@ -82,6 +108,9 @@ namespace toy
 	{
 		float pixelRatio = 1.f;
 		nvgBeginFrame(m_ctx, target.m_layer.m_size.x, target.m_layer.m_size.y, pixelRatio);
+
+		// nvgBeginFrame resets the nanovg state stack, so we forget what we know of it
+		m_textStates = { { -1, 0.f, -1 } };
 	}
 
 	void NanoRenderer::endFrame()
@@ -92,14 +121,18 @@ namespace toy
 	bool NanoRenderer::clipTest(const BoxFloat& rect)
 	{
 		BoxFloat scissor;
-		nvgCurrentScissor(m_ctx, scissor.pointer());
-
-		if(scissor.x1 < 0.f || scissor.y1 < 0.f)
+		if(!this->clipBounds(scissor))
 			return false;
 
 		return !rect.intersects(scissor);
 	}
 
+	bool NanoRenderer::clipBounds(BoxFloat& bounds)
+	{
+		nvgCurrentScissor(m_ctx, bounds.pointer());
+		return !(bounds.x1 < 0.f || bounds.y1 < 0.f);
+	}
+
 	void NanoRenderer::clipRect(const BoxFloat& rect)
 	{
 		nvgIntersectScissor(m_ctx, rect.x, rect.y, rect.w, rect.h);
@@ -252,6 +285,125 @@ namespace toy
 	}
 
 
+	void NanoRenderer::saveState()
+	{
+		nvgSave(m_ctx);
+		m_textStates.push_back(m_textStates.back());
+	}
+
+	void NanoRenderer::restoreState()
+	{
+		nvgRestore(m_ctx);
+		if(m_textStates.size() > 1)
+			m_textStates.pop_back();
+	}
+
+	int NanoRenderer::fontFace(const string& font)
+	{
+		auto it = m_fontFaces.find(font);
+		if(it != m_fontFaces.end())
+			return it->second;
+
+		int face = nvgFindFont(m_ctx, font.c_str());
+		m_fontFaces[font] = face;
+		return face;
+	}
+
+	float NanoRenderer::fontLineHeight(int face, float size)
+	{
+		uint64_t key = fontKey(face, size);
+
+		auto it = m_lineHeights.find(key);
+		if(it != m_lineHeights.end())
+			return it->second;
+
+		// the font state is already set by setupText when we get here
+		float lineHeight = 0.f;
+		nvgTextMetrics(m_ctx, nullptr, nullptr, &lineHeight);
+		m_lineHeights[key] = lineHeight;
+		return lineHeight;
+	}
+
+	NanoRenderer::AdvanceTable& NanoRenderer::advanceTable()
+	{
+		TextState& state = m_textStates.back();
+		uint64_t key = fontKey(state.m_face, state.m_size);
+		if(m_advanceTable && m_advanceKey == key)
+			return *m_advanceTable;
+
+		m_advanceKey = key;
+		auto it = m_advanceTables.find(key);
+		if(it != m_advanceTables.end())
+			return *(m_advanceTable = &it->second);
+
+		AdvanceTable& table = m_advanceTables[key];
+		m_advanceTable = &table;
+
+		// glyph bounds are measured left aligned so that they are relative to the pen position
+		nvgTextAlign(m_ctx, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
+
+		float bounds[4];
+		for(int i = 0; i < AdvanceTable::s_glyphs; ++i)
+		{
+			char glyph = char(' ' + i);
+			table.m_advances[i] = nvgTextBounds(m_ctx, 0.f, 0.f, &glyph, &glyph + 1, bounds);
+			table.m_left[i] = bounds[0];
+			table.m_right[i] = bounds[2];
+		}
+
+		nvgTextAlign(m_ctx, state.m_align);
+
+		table.m_kerning.assign(AdvanceTable::s_glyphs * AdvanceTable::s_glyphs, c_unmeasured);
+		return table;
+	}
+
+	float NanoRenderer::kerning(AdvanceTable& table, int first, int second)
+	{
+		float& kerning = table.m_kerning[first * AdvanceTable::s_glyphs + second];
+		if(kerning == c_unmeasured)
+		{
+			char pair[2] = { char(' ' + first), char(' ' + second) };
+			kerning = nvgTextBounds(m_ctx, 0.f, 0.f, pair, pair + 2, nullptr) - table.m_advances[first] - table.m_advances[second];
+		}
+		return kerning;
+	}
+
+	float NanoRenderer::textWidth(const char* start, const char* end)
+	{
+		// the font state is already set by setupText when we get here
+		if(start == end)
+			return 0.f;
+
+		// same extent as nvgTextBounds gives, accumulated from the glyph tables : any glyph outside of them takes the full path
+		AdvanceTable& table = this->advanceTable();
+
+		float pen = 0.f;
+		float left = 0.f;
+		float right = 0.f;
+		int previous = -1;
+
+		for(const char* c = start; c < end; ++c)
+		{
+			int glyph = int((unsigned char)(*c)) - ' ';
+			if(glyph < 0 || glyph >= AdvanceTable::s_glyphs)
+			{
+				float bounds[4];
+				nvgTextBounds(m_ctx, 0.f, 0.f, start, end, bounds);
+				return bounds[2] - bounds[0];
+			}
+
+			if(previous >= 0)
+				pen += this->kerning(table, previous, glyph);
+
+			left = std::min(left, pen + table.m_left[glyph]);
+			right = std::max(right, pen + table.m_right[glyph]);
+			pen += table.m_advances[glyph];
+			previous = glyph;
+		}
+
+		return right - left;
+	}
+
 	void NanoRenderer::setupText(InkStyle& skin)
 	{
 		NVGalign alignH = NVG_ALIGN_LEFT;
@@ -260,12 +412,28 @@ namespace toy
 		else if(skin.m_align.x == RIGHT)
 			alignH = NVG_ALIGN_RIGHT;
 
-		nvgFontSize(m_ctx, skin.m_text_size);
-		nvgFontFace(m_ctx, skin.m_text_font.c_str());
-		nvgTextAlign(m_ctx, alignH | NVG_ALIGN_TOP);
+		int align = alignH | NVG_ALIGN_TOP;
+		int face = this->fontFace(skin.m_text_font);
 
-		m_lineHeight = 0.f;
-		nvgTextMetrics(m_ctx, nullptr, nullptr, &m_lineHeight);
+		// only touch the nanovg font state when it actually changes
+		TextState& state = m_textStates.back();
+		if(state.m_size != skin.m_text_size)
+		{
+			nvgFontSize(m_ctx, skin.m_text_size);
+			state.m_size = skin.m_text_size;
+		}
+		if(state.m_face != face)
+		{
+			nvgFontFaceId(m_ctx, face);
+			state.m_face = face;
+		}
+		if(state.m_align != align)
+		{
+			nvgTextAlign(m_ctx, align);
+			state.m_align = align;
+		}
+
+		m_lineHeight = this->fontLineHeight(face, skin.m_text_size);
 	}
 
 	void NanoRenderer::fillText(const string& text, const BoxFloat& rect, InkStyle& skin, TextRow& row)
@@ -274,7 +442,7 @@ namespace toy
 
 		row.start = text.c_str();
 		row.end = text.c_str() + text.size();
-		row.rect.assign(rect.x, rect.y, this->textSize(text, DIM_X, skin), m_lineHeight);
+		row.rect.assign(rect.x, rect.y, this->textWidth(row.start, row.end), m_lineHeight);
 
 		this->breakTextLine(rect, row);
 	}
@@ -292,6 +460,8 @@ namespace toy
 
 		if(row.start != row.end)
 			this->breakTextLine(rect, row);
+		else
+			row.glyphs.clear();
 	}
 
 	void NanoRenderer::breakTextReturns(const char* first, const char* end, const BoxFloat& rect, InkStyle& skin, TextRow& row)
@@ -304,7 +474,7 @@ namespace toy
 
 		row.start = first;
 		row.end = iter;
-		row.rect.assign(rect.x, rect.y, this->textSize(string(first, iter - first), DIM_X, skin), m_lineHeight);
+		row.rect.assign(rect.x, rect.y, this->textWidth(first, iter), m_lineHeight);
 
 		this->breakTextLine(rect, row);
 	}
@@ -313,8 +483,7 @@ namespace toy
 	{
 		this->setupText(skin);
 
-		textRows.clear();
-	
+		// rows are reused from the previous break so that their glyph vectors keep their storage
 		if(!skin.m_text_break)
 		{
 			textRows.resize(1);
@@ -327,11 +496,12 @@ namespace toy
 		const char* first = text.c_str();
 		const char* end = first + text.size();
 
+		size_t index = 0;
 		while(first < end)
 		{
-			size_t index = textRows.size();
-			textRows.resize(index + 1);
-			TextRow& row = textRows.back();
+			if(index == textRows.size())
+				textRows.emplace_back();
+			TextRow& row = textRows[index];
 
 			BoxFloat rect(0.f, index * m_lineHeight, space.x, 0.f);
 			if(skin.m_text_wrap)
@@ -342,16 +512,23 @@ namespace toy
 			row.startIndex = row.start - text.c_str();
 			row.endIndex = row.end - text.c_str();
 			first = row.end + 1;
+			++index;
 		}
+
+		textRows.resize(index);
 	}
 
 	void NanoRenderer::breakTextLine(const BoxFloat& rect, TextRow& textRow)
 	{
+		std::vector<NVGglyphPosition>& positions = m_glyphPositions;
+
 		size_t numGlyphs = textRow.end - textRow.start;
-		std::vector<NVGglyphPosition> positions;
 		positions.resize(numGlyphs);
 		textRow.glyphs.resize(numGlyphs);
 
+		if(numGlyphs == 0)
+			return;
+
 		nvgTextGlyphPositions(m_ctx, rect.x, rect.y, textRow.start, textRow.end, &positions.front(), positions.size());
 
 		for(size_t i = 0; i < positions.size(); ++i)
@@ -363,19 +540,49 @@ namespace toy
 		}
 	}
 
-	void NanoRenderer::drawText(float x, float y, const char* start, const char* end, InkStyle& skin)
+	float NanoRenderer::glyphScale()
+	{
+		// same computation as nanovg does to pick the size at which it rasterizes glyphs
+		float xform[6];
+		nvgCurrentTransform(m_ctx, xform);
+		float sx = sqrtf(xform[0] * xform[0] + xform[2] * xform[2]);
+		float sy = sqrtf(xform[1] * xform[1] + xform[3] * xform[3]);
+		float scale = floorf((sx + sy) * 0.5f / 0.01f + 0.5f) * 0.01f;
+		return std::min(scale, c_glyphMaxScale);
+	}
+
+	void NanoRenderer::snapGlyphSize(float size, float scale)
+	{
+		// pick the font size whose rasterization lands on the closest glyph size bucket :
+		// continuous zooming then only ever hits a bounded set of glyph sizes in the font atlas
+		float glyphSize = std::max(c_glyphSizeStep, floorf(size * scale / c_glyphSizeStep + 0.5f) * c_glyphSizeStep);
+		float snapped = (glyphSize + 0.01f) / scale;
+
+		TextState& state = m_textStates.back();
+		if(state.m_size != snapped)
+		{
+			nvgFontSize(m_ctx, snapped);
+			state.m_size = snapped;
+		}
+	}
+
+	float NanoRenderer::drawText(float x, float y, const char* start, const char* end, InkStyle& skin)
 	{
 		this->setupText(skin);
 
+		float scale = this->glyphScale();
+		if(scale > 0.f && scale != 1.f)
+			this->snapGlyphSize(skin.m_text_size, scale);
+
 		nvgFillColor(m_ctx, nvgColour(skin.m_text_colour));
-		nvgText(m_ctx, x, y, start, end);
+		return nvgText(m_ctx, x, y, start, end);
 	}
 
 	void NanoRenderer::beginTarget()
 	{
 		m_debugDepth++;
 
-		nvgSave(m_ctx);
+		this->saveState();
 		nvgResetTransform(m_ctx);
 		nvgResetScissor(m_ctx);
 	}
@@ -384,7 +591,7 @@ namespace toy
 	{
 		m_debugDepth--;
 
-		nvgRestore(m_ctx);
+		this->restoreState();
 	}
 
 #ifdef TOYUI_DRAW_CACHE
@@ -398,11 +605,11 @@ namespace toy
 
 	void NanoRenderer::drawLayer(void* layerCache, float x, float y, float scale)
 	{
-		nvgSave(m_ctx);
+		this->saveState();
 		nvgTranslate(m_ctx, x, y);
 		nvgScale(m_ctx, scale, scale);
 		nvgDrawDisplayList(m_ctx, (NVGdisplayList*)layerCache);
-		nvgRestore(m_ctx);
+		this->restoreState();
 	}
 
 	void NanoRenderer::clearLayer(void* layerCache)
@@ -416,7 +623,7 @@ namespace toy
 		m_debugDepth++;
 
 		nvgBindDisplayList(m_ctx, (NVGdisplayList*)layerCache);
-		nvgSave(m_ctx);
+		this->saveState();
 		nvgTranslate(m_ctx, x, y);
 		nvgScale(m_ctx, scale, scale);
 	}
@@ -425,20 +632,20 @@ namespace toy
 	{
 		m_debugDepth--;
 
-		nvgRestore(m_ctx);
+		this->restoreState();
 		nvgBindDisplayList(m_ctx, nullptr);
 	}
 
 #else
 	void NanoRenderer::beginUpdate(float x, float y)
 	{
-		nvgSave(m_ctx);
+		this->saveState();
 		nvgTranslate(m_ctx, x, y);
 	}
 
 	void NanoRenderer::endUpdate()
 	{
-		nvgRestore(m_ctx);
+		this->restoreState();
 	}
 #endif
 
@@ -452,9 +659,6 @@ namespace toy
 	{
 		this->setupText(skin);
 
-		float bounds[4];
-		nvgTextBounds(m_ctx, 0.f, 0.f, text.c_str(), nullptr, bounds);
-
-		return dim == DIM_X ? bounds[2] - bounds[0] : m_lineHeight;
+		return dim == DIM_X ? this->textWidth(text.c_str(), text.c_str() + text.size()) : m_lineHeight;
 	}
 }
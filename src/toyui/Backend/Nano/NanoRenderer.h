@@ -15,6 +15,7 @@ namespace toy
 	{
 	public:
 		NanoRenderer(const string& resourcePath);
+		~NanoRenderer();
 
 		// targets
 		virtual object_ptr<RenderTarget> createRenderTarget(Layer& layer);
@@ -46,6 +47,7 @@ namespace toy
 #endif
 
 		virtual bool clipTest(const BoxFloat& rect) final;
+		virtual bool clipBounds(BoxFloat& bounds) final;
 		virtual void clipRect(const BoxFloat& rect) final;
 		virtual void unclipRect() final;
 
@@ -58,7 +60,7 @@ namespace toy
 		virtual void drawRect(const BoxFloat& rect, const BoxFloat& corners, InkStyle& skin) final;
 		virtual void drawImage(const Image& image, const BoxFloat& rect) final;
 		virtual void drawImageStretch(const Image& image, const BoxFloat& rect, float xstretch = 1.f, float ystretch = 1.f) final;
-		virtual void drawText(float x, float y, const char* start, const char* end, InkStyle& skin) final;
+		virtual float drawText(float x, float y, const char* start, const char* end, InkStyle& skin) final;
 
 		virtual void debugRect(const BoxFloat& rect, const Colour& colour) final;
 
@@ -80,6 +82,30 @@ namespace toy
 	private:
 		void setupText(InkStyle& skin);
 
+		int fontFace(const string& font);
+		float fontLineHeight(int face, float size);
+
+		// measured metrics of the printable ascii glyphs, for one font face and size
+		struct AdvanceTable
+		{
+			static const int s_glyphs = '~' - ' ' + 1;
+
+			float m_advances[s_glyphs];
+			float m_left[s_glyphs];
+			float m_right[s_glyphs];
+			std::vector<float> m_kerning;
+		};
+
+		AdvanceTable& advanceTable();
+		float kerning(AdvanceTable& table, int first, int second);
+		float textWidth(const char* start, const char* end);
+
+		float glyphScale();
+		void snapGlyphSize(float size, float scale);
+
+		void saveState();
+		void restoreState();
+
 		void drawImage(int image, const BoxFloat& rect, const BoxFloat& imageRect);
 
 	protected:
@@ -87,6 +113,24 @@ namespace toy
 
 		float m_lineHeight;
 
+		struct TextState
+		{
+			int m_face;
+			float m_size;
+			int m_align;
+		};
+
+		std::vector<TextState> m_textStates;
+		std::map<string, int> m_fontFaces;
+		std::map<uint64_t, float> m_lineHeights;
+
+		std::map<uint64_t, AdvanceTable> m_advanceTables;
+		uint64_t m_advanceKey;
+		AdvanceTable* m_advanceTable;
+
+		// scratch buffer for breaking text lines, kept across calls to avoid allocating
+		std::vector<NVGglyphPosition> m_glyphPositions;
+
 		std::map<Layer*, NVGdisplayList*> m_layers;
 	};
 }
@@ -8,6 +8,8 @@
 #include <toyobj/Bundle.h>
 
 /* toy ui */
+#include <toyui/Log.h>
+
 #include <toyui/Frame/Frame.h>
 #include <toyui/Frame/Layer.h>
 
@@ -18,6 +20,8 @@
 #include <toyui/Frame/Caption.h>
 
 #include <toyui/Style/StyleParser.h>
+#include <toyui/Style/StyleCompiler.h>
+#include <toyui/Style/StyleTransition.h>
 
 #include <toyui/Widget/Widget.h>
 #include <toyui/Widget/Sheet.h>
@@ -35,6 +39,8 @@
 #include <toyui/Button/RadioButton.h>
 #include <toyui/Button/Filter.h>
 
+#include <toyui/Frame/Highlighter.h>
+
 #include <toyui/Edit/TypeIn.h>
 #include <toyui/Edit/Textbox.h>
 #include <toyui/Edit/Input.h>
@@ -55,6 +61,8 @@
 #include <toyui/Window/Popup.h>
 
 #include <toyui/Input/InputDevice.h>
+#include <toyui/Input/InputRecord.h>
+#include <toyui/Input/Accelerators.h>
 
 #include <toyui/Render/Renderer.h>
 
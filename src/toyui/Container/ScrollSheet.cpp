@@ -98,7 +98,7 @@ namespace toy
 			scale = std::max(scale, std::max(minScale.x, minScale.y));
 		}
 
-		m_plan.frame().d_scale = scale;
+		m_plan.frame().setScale(scale);
 		m_frame->markDirty(DIRTY_FORCE_LAYOUT);
 
 		DimFloat offset = mouseEvent.m_relative - mouseEvent.m_relative * deltaScale;
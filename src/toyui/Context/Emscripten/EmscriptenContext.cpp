@@ -229,42 +229,42 @@ namespace toy
 		float clampedX = std::max(0.f, std::min(float(m_renderWindow->m_width), m_mouseX));
 		float clampedY = std::max(0.f, std::min(float(m_renderWindow->m_height), m_mouseY));
 
-		m_mouse->dispatchMouseMoved({ clampedX, clampedY }); // , mouseEvent.movementX, mouseEvent.movementY
+		m_queue.pushMouseMoved({ clampedX, clampedY }); // , mouseEvent.movementX, mouseEvent.movementY
 	}
 
 	bool EmInputWindow::injectMouseDown(const EmscriptenMouseEvent& mouseEvent)
 	{
-		m_mouse->dispatchMousePressed({ float(mouseEvent.canvasX), float(mouseEvent.canvasY) }, convertHtml5MouseButton(mouseEvent.button));
+		m_queue.pushMousePressed({ float(mouseEvent.canvasX), float(mouseEvent.canvasY) }, convertHtml5MouseButton(mouseEvent.button));
 		return true;
 	}
 
 	bool EmInputWindow::injectMouseUp(const EmscriptenMouseEvent& mouseEvent)
 	{
-		m_mouse->dispatchMouseReleased({ float(mouseEvent.canvasX),float(mouseEvent.canvasY) }, convertHtml5MouseButton(mouseEvent.button));
+		m_queue.pushMouseReleased({ float(mouseEvent.canvasX),float(mouseEvent.canvasY) }, convertHtml5MouseButton(mouseEvent.button));
 		return true;
 	}
 
 	bool EmInputWindow::injectKeyDown(const EmscriptenKeyboardEvent& keyEvent)
 	{
-		m_keyboard->dispatchKeyPressed(convertHtml5Key(keyEvent.key), keyEvent.code[0]);
+		m_queue.pushKeyPressed(convertHtml5Key(keyEvent.key), keyEvent.code[0]);
 		return true;
 	}
 
 	bool EmInputWindow::injectKeyUp(const EmscriptenKeyboardEvent& keyEvent)
 	{
-		m_keyboard->dispatchKeyReleased(convertHtml5Key(keyEvent.key), keyEvent.code[0]);
+		m_queue.pushKeyReleased(convertHtml5Key(keyEvent.key), keyEvent.code[0]);
 		return true;
 	}
 
 	bool EmInputWindow::injectKeyPress(const EmscriptenKeyboardEvent& keyEvent)
 	{
-		m_keyboard->dispatchKeyReleased(convertHtml5Key(keyEvent.key), keyEvent.code[0]);
+		m_queue.pushKeyReleased(convertHtml5Key(keyEvent.key), keyEvent.code[0]);
 		return true;
 	}
 
 	bool EmInputWindow::injectWheel(const EmscriptenWheelEvent& wheelEvent)
 	{
-		m_mouse->dispatchMouseWheeled({ m_mouseX, m_mouseY }, wheelEvent.deltaY);
+		m_queue.pushMouseWheeled({ m_mouseX, m_mouseY }, wheelEvent.deltaY);
 	}
 
 	EmContext::EmContext(RenderSystem& renderSystem, const string& name, int width, int height, bool fullScreen)
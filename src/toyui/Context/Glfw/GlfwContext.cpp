@@ -292,7 +292,7 @@ namespace toy
 		m_cursorX = clampedX;
 		m_cursorY = clampedY;
 
-		m_mouse->dispatchMouseMoved({ clampedX, clampedY });
+		m_queue.pushMouseMoved({ clampedX, clampedY });
 	}
 
 	void GlfwInputWindow::injectMouseButton(int button, int action, int mods)
@@ -302,29 +302,29 @@ namespace toy
 
 		UNUSED(mods);
 		if(action == GLFW_PRESS)
-			m_mouse->dispatchMousePressed({ clampedX, clampedY }, convertGlfwButton(button));
+			m_queue.pushMousePressed({ clampedX, clampedY }, convertGlfwButton(button));
 		else if(action == GLFW_RELEASE)
-			m_mouse->dispatchMouseReleased({ clampedX, clampedY }, convertGlfwButton(button));
+			m_queue.pushMouseReleased({ clampedX, clampedY }, convertGlfwButton(button));
 	}
 
 	void GlfwInputWindow::injectKey(int key, int scancode, int action, int mods)
 	{
 		UNUSED(scancode); UNUSED(mods);
 		if(action == GLFW_PRESS)
-			m_keyboard->dispatchKeyPressed(convertGlfwKey(key), (char) 0);
+			m_queue.pushKeyPressed(convertGlfwKey(key), (char) 0);
 		else if(action == GLFW_RELEASE)
-			m_keyboard->dispatchKeyReleased(convertGlfwKey(key), (char) 0);
+			m_queue.pushKeyReleased(convertGlfwKey(key), (char) 0);
 	}
 
 	void GlfwInputWindow::injectChar(unsigned int codepoint, int mods)
 	{
 		UNUSED(codepoint); UNUSED(mods);
-		m_keyboard->dispatchKeyPressed((KeyCode) 0, (char) codepoint);
+		m_queue.pushKeyPressed((KeyCode) 0, (char) codepoint);
 	}
 
 	void GlfwInputWindow::injectWheel(double x, double y)
 	{
-		m_mouse->dispatchMouseWheeled({ m_mouseX, m_mouseY }, x + y);
+		m_queue.pushMouseWheeled({ m_mouseX, m_mouseY }, x + y);
 	}
 
 	GlfwContext::GlfwContext(RenderSystem& renderSystem, const string& name, int width, int height, bool fullScreen, bool autoSwap)
@@ -547,7 +547,7 @@ namespace toy
 				input.setMousePos(mx, my);
 			}
 
-			input.m_mouse->dispatchMouseMoved({ float(mx), float(my) });
+			input.m_queue.pushMouseMoved({ float(mx), float(my) });
 		}
 		break;
 
@@ -558,7 +558,7 @@ namespace toy
 			int32_t mx = pt.x;
 			int32_t my = pt.y;
 			input.m_mouse_z += GET_WHEEL_DELTA_WPARAM(_wparam) / WHEEL_DELTA;
-			input.m_mouse->dispatchMouseWheeled({ float(mx), float(my) }, input.m_mouse_z);
+			input.m_queue.pushMouseWheeled({ float(mx), float(my) }, input.m_mouse_z);
 		}
 		break;
 
@@ -569,7 +569,7 @@ namespace toy
 			input.mouseCapture(true);
 			int32_t mx = GET_X_LPARAM(_lparam);
 			int32_t my = GET_Y_LPARAM(_lparam);
-			input.m_mouse->dispatchMousePressed({ float(mx), float(my) }, mouseButton(_id));
+			input.m_queue.pushMousePressed({ float(mx), float(my) }, mouseButton(_id));
 		}
 		break;
 
@@ -580,7 +580,7 @@ namespace toy
 			input.mouseCapture(false);
 			int32_t mx = GET_X_LPARAM(_lparam);
 			int32_t my = GET_Y_LPARAM(_lparam);
-			input.m_mouse->dispatchMouseReleased({ float(mx), float(my) }, mouseButton(_id));
+			input.m_queue.pushMouseReleased({ float(mx), float(my) }, mouseButton(_id));
 		}
 		break;
 
@@ -595,7 +595,7 @@ namespace toy
 			uint8_t modifiers = translateKeyModifiers();
 			KeyCode key = translateKey(_wparam);
 			printf("key down\n");
-			input.m_keyboard->dispatchKeyPressed(key, '0');
+			input.m_queue.pushKeyPressed(key, '0');
 		}
 		break;
 
@@ -615,7 +615,7 @@ namespace toy
 			}*/
 
 			printf("key released\n");
-			input.m_keyboard->dispatchKeyReleased(key, '0');
+			input.m_queue.pushKeyReleased(key, '0');
 		}
 		break;
 
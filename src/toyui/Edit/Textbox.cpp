@@ -10,12 +10,30 @@
 #include <toyobj/Any.h>
 
 #include <toyui/Frame/Frame.h>
+#include <toyui/Frame/Caption.h>
 
 #include <toyui/Widget/Sheet.h>
 
+#include <toyui/Style/Style.h>
+#include <toyui/Log.h>
+
 namespace toy
 {
 	Textbox::Textbox(const Params& params, string& text)
 		: TypeIn({ params, &cls<Textbox>() }, text, nullptr, true)
 	{}
+
+	void Textbox::setLexer(Lexer* lexer)
+	{
+		// the renderer only draws highlighted runs for left aligned text
+		if(lexer && m_style->skin(m_state).m_align.x != LEFT)
+		{
+			Log::print(LOG_WARNING, "Textbox text isn't left aligned, it can't be highlighted\n");
+			lexer = nullptr;
+		}
+
+		m_caption.setHighlighter(nullptr);
+		m_highlighter.reset(lexer ? new Highlighter(*lexer) : nullptr);
+		m_caption.setHighlighter(m_highlighter.get());
+	}
 }
@@ -8,6 +8,7 @@
 /* toy */
 #include <toyui/Types.h>
 #include <toyui/Edit/TypeIn.h>
+#include <toyui/Frame/Highlighter.h>
 
 namespace toy
 {
@@ -15,6 +16,11 @@ namespace toy
 	{
 	public:
 		Textbox(const Params& params, string& text);
+
+		void setLexer(Lexer* lexer);
+
+	protected:
+		unique_ptr<Highlighter> m_highlighter;
 	};
 }
 
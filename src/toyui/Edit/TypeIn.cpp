@@ -57,9 +57,14 @@ namespace toy
 		if(m_caption.m_caret == 0 && m_caption.m_selectStart == m_caption.m_selectEnd)
 			return;
 
+		size_t offset = m_caption.m_selectStart;
+		size_t erased = m_caption.m_selectEnd - m_caption.m_selectStart;
+
 		if(m_caption.m_selectStart == m_caption.m_selectEnd)
 		{
-			m_text.erase(m_text.begin() + m_caption.m_selectStart - 1);
+			offset = m_caption.m_selectStart - 1;
+			erased = 1;
+			m_text.erase(m_text.begin() + offset);
 			this->moveCaretLeft();
 		}
 		else
@@ -68,13 +73,14 @@ namespace toy
 			this->selectCaret(m_caption.m_selectStart);
 		}
 
-		this->changed();
+		this->changed(offset, erased, 0);
 	}
 
 	void TypeIn::insert(char c)
 	{
-		m_text.insert(m_text.begin() + m_caption.m_caret, c);
-		this->changed();
+		size_t offset = m_caption.m_caret;
+		m_text.insert(m_text.begin() + offset, c);
+		this->changed(offset, 0, 1);
 		this->moveCaretRight();
 	}
 
@@ -83,11 +89,17 @@ namespace toy
 		m_caption.setText(m_text);
 	}
 
-	void TypeIn::changed()
+	void TypeIn::changed(size_t offset, size_t erased, size_t inserted)
 	{
+		size_t size = m_text.size();
 		if(m_callback)
 			m_text = m_callback(m_text);
-		m_caption.setText(m_text);
+
+		// a callback reshaping the text invalidates the edit range
+		if(m_text.size() == size)
+			m_caption.editText(m_text, offset, erased, inserted);
+		else
+			m_caption.setText(m_text);
 	}
 
 	bool TypeIn::leftClick(MouseEvent& mouseEvent)
@@ -31,7 +31,7 @@ namespace toy
 		void erase();
 		void insert(char c);
 		void update();
-		void changed();
+		void changed(size_t offset, size_t erased, size_t inserted);
 
 		void activate();
 
@@ -9,6 +9,7 @@
 #include <toyobj/Forward.h>
 
 struct NVGcontext;
+struct NVGglyphPosition;
 struct NVGdisplayList;
 struct GLFWwindow;
 
@@ -64,6 +65,10 @@ namespace toy
 	class Layout;
 
 	struct TextRow;
+	struct TextSpan;
+
+	class Lexer;
+	class Highlighter;
 
 	class Caption;
 	class Icon;
@@ -72,6 +77,8 @@ namespace toy
 	class ImageSkin;
 	class Paint;
 	class InkStyle;
+	enum StyleChange : unsigned int;
+	using StyleId = size_t;
 
 	class FrameSolver;
 	class RowSolver;
@@ -179,9 +186,15 @@ namespace toy
 	class RenderTarget;
 
 	class Styler;
+	class StyleTransitions;
 
 	class RenderWindow;
 	class InputWindow;
+	class InputQueue;
+	class InputLatency;
+	class AcceleratorTable;
+	class RecordInputWindow;
+	class ReplayInputWindow;
 	class Context;
 	class RenderSystem;
 
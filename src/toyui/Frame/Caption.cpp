@@ -6,9 +6,12 @@
 #include <toyui/Frame/Caption.h>
 
 #include <toyui/Frame/Layer.h>
+#include <toyui/Frame/Highlighter.h>
 
 #include <toyui/Render/Renderer.h>
 
+#include <algorithm>
+
 namespace toy
 {
 	Renderer* Caption::s_renderer = nullptr;
@@ -20,11 +23,22 @@ namespace toy
 		, m_caret(-1)
 		, m_selectStart(-1)
 		, m_selectEnd(-1)
+		, m_highlighter(nullptr)
 	{}
 
 	void Caption::setText(const string& text)
 	{
 		m_text = text;
+		if(m_highlighter)
+			m_highlighter->lex(m_text);
+		d_frame.markDirty(DIRTY_LAYOUT);
+	}
+
+	void Caption::editText(const string& text, size_t offset, size_t erased, size_t inserted)
+	{
+		m_text = text;
+		if(m_highlighter)
+			m_highlighter->edit(m_text, offset, erased, inserted);
 		d_frame.markDirty(DIRTY_LAYOUT);
 	}
 
@@ -34,6 +48,14 @@ namespace toy
 		d_frame.markDirty(DIRTY_LAYOUT);
 	}
 
+	void Caption::setHighlighter(Highlighter* highlighter)
+	{
+		m_highlighter = highlighter;
+		if(m_highlighter)
+			m_highlighter->lex(m_text);
+		d_frame.markDirty(DIRTY_REDRAW);
+	}
+
 	DimFloat Caption::updateTextSize()
 	{
 		//DimFloat paddedSize = d_frame.m_size - d_frame.d_inkstyle->m_padding - d_frame.d_inkstyle->m_padding;
@@ -162,6 +184,17 @@ namespace toy
 		}
 	}
 
+	void Caption::visibleRows(float top, float bottom, size_t& first, size_t& last)
+	{
+		// rows are laid out top to bottom, so both bounds can be found by bisection
+		auto begin = m_textRows.begin();
+		auto firstRow = std::lower_bound(begin, m_textRows.end(), top, [](const TextRow& row, float y) { return row.rect.y + row.rect.h <= y; });
+		auto lastRow = std::lower_bound(firstRow, m_textRows.end(), bottom, [](const TextRow& row, float y) { return row.rect.y < y; });
+
+		first = firstRow - begin;
+		last = lastRow - begin;
+	}
+
 	TextRow& Caption::textRow(size_t index)
 	{
 		for(TextRow& row : m_textRows)
@@ -45,7 +45,9 @@ namespace toy
 		float width();
 
 		void setText(const string& text);
+		void editText(const string& text, size_t offset, size_t erased, size_t inserted);
 		void setTextLines(size_t lines);
+		void setHighlighter(Highlighter* highlighter);
 
 		DimFloat updateTextSize();
 
@@ -53,6 +55,7 @@ namespace toy
 		void updateSelection();
 
 		TextRow& textRow(size_t index);
+		void visibleRows(float top, float bottom, size_t& first, size_t& last);
 
 		size_t caretIndex(const DimFloat& pos);
 		void caretCoords(DimFloat& pos);
@@ -68,6 +71,8 @@ namespace toy
 
 		std::vector<TextRow> m_textRows;
 
+		Highlighter* m_highlighter;
+
 	public:
 		static Renderer* s_renderer;
 	};
@@ -14,6 +14,9 @@
 #include <toyui/Frame/Layer.h>
 
 #include <toyui/Style/Style.h>
+#include <toyui/Style/StyleTransition.h>
+
+#include <toyui/Input/InputLatency.h>
 
 #include <cmath>
 #include <cassert>
@@ -22,6 +25,8 @@ namespace toy
 {
 	template <> string to_string<DirtyLayout>(const DirtyLayout& dirty) { if(dirty == CLEAN) return "CLEAN"; else if(dirty == DIRTY_REDRAW) return "DIRTY_REDRAW"; else if(dirty == DIRTY_PARENT) return "DIRTY_PARENT"; else if(dirty == DIRTY_LAYOUT) return "DIRTY_LAYOUT"; else if(dirty == DIRTY_FORCE_LAYOUT) return "DIRTY_FORCE_LAYOUT"; else /*if(dirty == DIRTY_STRUCTURE)*/ return "DIRTY_STRUCTURE"; }
 
+	size_t Frame::s_transformStamp = 0;
+
 	Frame::Frame(Widget& widget)
 		: UiRect()
 		, d_widget(widget)
@@ -29,19 +34,29 @@ namespace toy
 		, d_parent(nullptr)
 		, d_dirty(DIRTY_STRUCTURE)
 		, d_hidden(false)
+		, d_overlay(false)
 		, d_index(0, 0)
 		, d_hardClip()
 		, m_opacity(CLEAR)
 		, d_length(DIM_NULL)
 		, d_style(nullptr)
 		, d_inkstyle(nullptr)
+		, d_absoluteOffset(0.f, 0.f)
+		, d_offsetScale(1.f)
+		, d_absoluteScale(1.f)
+		, d_transformStamp(0)
+		, d_parentStamp(0)
+		, d_transformDirty(true)
 		, d_caption()
 		, d_icon()
 		, m_solver()
 	{}
 
 	Frame::~Frame()
-	{}
+	{
+		if(StyleTransitions::s_active)
+			StyleTransitions::s_active->cancel(*this);
+	}
 
 	void Frame::makeSolver()
 	{
@@ -78,7 +93,23 @@ namespace toy
 		this->setDirty(dirty);
 		if(dirty == DIRTY_FORCE_LAYOUT)
 			dirty = DIRTY_LAYOUT;
-		Frame* parent = this->d_parent;
+
+		if(InputLatency::s_active)
+			InputLatency::s_active->dirtied();
+
+		Frame* frame = this;
+		while(frame && frame->frameType() < LAYER)
+		{
+			frame = frame->d_parent;
+			if(frame)
+				frame->setDirty(dirty);
+		}
+
+		// the nearest layer hit-tests this frame through its spatial index : only a change of the tree invalidates it as a whole
+		if(frame && dirty == DIRTY_STRUCTURE)
+			as<Layer>(*frame).setIndexDirty();
+
+		Frame* parent = frame ? frame->d_parent : nullptr;
 		while(parent)
 		{
 			parent->setDirty(dirty);
@@ -86,10 +117,46 @@ namespace toy
 		}
 	}
 
+	void Frame::markIndexDirty()
+	{
+		Frame* frame = this;
+		while(frame && frame->frameType() < LAYER)
+			frame = frame->d_parent;
+
+		if(frame)
+			as<Layer>(*frame).setIndexDirty();
+	}
+
+	void Frame::markMoved()
+	{
+		// the bounds of the frame and its subtree are updated in place in the spatial index of the nearest layer
+		Frame* frame = this;
+		while(frame && frame->frameType() < LAYER)
+			frame = frame->d_parent;
+
+		if(frame)
+			as<Layer>(*frame).moveIndexed(*this);
+	}
+
+	void Frame::markRepaint()
+	{
+		if(InputLatency::s_active)
+			InputLatency::s_active->dirtied();
+
+		// only the pixels changed : the owning layer is repainted alone, without touching the layout, the ancestors or the spatial index
+		Frame* frame = this;
+		while(frame && frame->frameType() < LAYER)
+			frame = frame->d_parent;
+
+		if(frame)
+			as<Layer>(*frame).setRedraw();
+	}
+
 	void Frame::bind(Frame& parent)
 	{
 		d_parent = &parent;
 		d_parent->markDirty(DIRTY_STRUCTURE);
+		this->invalidateTransform();
 		//d_index[d_parent->d_length] = d_widget.d_index;
 	}
 
@@ -97,19 +164,32 @@ namespace toy
 	{
 		d_parent->markDirty(DIRTY_STRUCTURE);
 		d_parent = nullptr;
+		this->invalidateTransform();
 	}
 
 	void Frame::setStyle(Style& style, bool reset)
 	{
 		if(d_style == &style) return;
+		if(d_style && d_style->m_layout.m_clipping != style.m_layout.m_clipping)
+			this->markIndexDirty();
 		d_style = &style;
 		this->updateStyle(reset);
 	}
 
 	void Frame::updateStyle(bool reset)
 	{
+		if(!d_style->resolved())
+			d_style->resolve();
+
+		if(m_opacity != d_style->m_layout.m_opacity)
+			this->markIndexDirty();
+
 		m_opacity = d_style->m_layout.m_opacity;
-		m_size = d_style->m_layout.m_size.null() ? m_size : d_style->m_layout.m_size;
+		if(!d_style->m_layout.m_size.null() && !(d_style->m_layout.m_size == m_size))
+		{
+			m_size = d_style->m_layout.m_size;
+			this->markMoved();
+		}
 
 		this->updateInkstyle(d_style->skin(d_widget.m_state));
 
@@ -120,13 +200,55 @@ namespace toy
 	{
 		if(d_inkstyle == &inkstyle) return;
 		//printf("INFO: Update inkstyle %s\n", inkstyle.m_name.c_str());
+		InkStyle* previous = d_inkstyle;
 		d_inkstyle = &inkstyle;
-		this->markDirty(DIRTY_REDRAW);
+
+		if(!previous)
+			this->markDirty(DIRTY_REDRAW);
+		else if(previous->paintOnly(inkstyle))
+		{
+			if(StyleTransitions::s_active)
+				StyleTransitions::s_active->start(*this, *previous, inkstyle);
+			this->markRepaint();
+		}
+		else
+		{
+			if(StyleTransitions::s_active)
+				StyleTransitions::s_active->cancel(*this);
+			this->markDirty(DIRTY_LAYOUT);
+		}
 
 		if(d_inkstyle->m_image)
 			this->setIcon(d_inkstyle->m_image);
 	}
 
+	void Frame::reloadStyle(const InkStyle& previous, StyleChange change)
+	{
+		// the style was reloaded in place : the previous skin is only used to tell how much changed
+		if(StyleTransitions::s_active)
+			StyleTransitions::s_active->cancel(*this);
+		d_inkstyle = &d_style->skin(d_widget.m_state);
+		if(!change)
+			return;
+
+		if(change >= STYLE_LAYOUT)
+		{
+			this->markIndexDirty();
+			m_opacity = d_style->m_layout.m_opacity;
+			m_size = d_style->m_layout.m_size.null() ? m_size : d_style->m_layout.m_size;
+		}
+
+		if(d_inkstyle->m_image && d_inkstyle->m_image != previous.m_image)
+			this->setIcon(d_inkstyle->m_image);
+
+		if(change & STYLE_STRUCTURE)
+			this->markDirty(DIRTY_STRUCTURE);
+		else if(change & STYLE_LAYOUT || !previous.paintOnly(*d_inkstyle))
+			this->markDirty(DIRTY_LAYOUT);
+		else
+			this->markRepaint();
+	}
+
 	Caption& Frame::setCaption(const string& text)
 	{
 		if(!d_caption) d_caption = make_object<Caption>(*this);
@@ -154,6 +276,7 @@ namespace toy
 	{
 		if(m_size[dim] == size) return;
 		m_size[dim] = size;
+		this->markMoved();
 		this->markDirty(DIRTY_FORCE_LAYOUT);
 	}
 
@@ -168,18 +291,41 @@ namespace toy
 	{
 		if(d_position[dim] == position) return;
 		d_position[dim] = position;
+		this->invalidateTransform();
+		// a layer indexes its content in its own space : moving it doesn't change its index
+		if(this->frameType() < LAYER)
+			this->markMoved();
 		this->markDirty(DIRTY_REDRAW);
 	}
 
+	void Frame::setOverlayPosition(const DimFloat& pos)
+	{
+		if(d_position == pos) return;
+		d_position = pos;
+		this->invalidateTransform();
+	}
+
+	void Frame::setScale(float scale)
+	{
+		if(d_scale == scale) return;
+		d_scale = scale;
+		this->invalidateTransform();
+		if(this->frameType() < LAYER)
+			this->markMoved();
+		this->markDirty(DIRTY_FORCE_LAYOUT);
+	}
+
 	void Frame::show()
 	{
 		d_hidden = false;
+		this->markIndexDirty();
 		this->markDirty(DIRTY_LAYOUT);
 	}
 
 	void Frame::hide()
 	{
 		d_hidden = true;
+		this->markIndexDirty();
 		this->markDirty(DIRTY_LAYOUT);
 	}
 
@@ -211,6 +357,36 @@ namespace toy
 		d_parent->derivePosition(root, local);
 	}
 
+	void Frame::updateTransform()
+	{
+		// the master layer is the root : its own position and scale don't apply to positions, only to the scale
+		bool root = !d_parent || this->frameType() >= MASTER_LAYER;
+		if(!root)
+			d_parent->updateTransform();
+
+		// only the frames below a moved one see a newer parent stamp, the rest of the tree keeps its cached transform
+		if(!d_transformDirty && (root || d_parentStamp == d_parent->d_transformStamp))
+			return;
+
+		if(root)
+		{
+			d_absoluteOffset = { 0.f, 0.f };
+			d_offsetScale = 1.f;
+			d_absoluteScale = d_scale;
+			d_parentStamp = 0;
+		}
+		else
+		{
+			d_absoluteOffset = { d_parent->d_absoluteOffset.x + d_position.x * d_parent->d_offsetScale, d_parent->d_absoluteOffset.y + d_position.y * d_parent->d_offsetScale };
+			d_offsetScale = d_parent->d_offsetScale * d_scale;
+			d_absoluteScale = d_parent->d_absoluteScale * d_scale;
+			d_parentStamp = d_parent->d_transformStamp;
+		}
+
+		d_transformStamp = ++s_transformStamp;
+		d_transformDirty = false;
+	}
+
 	float Frame::deriveScale(Frame& root)
 	{
 		if(this == &root)
@@ -369,7 +545,11 @@ namespace toy
 		//d_length = solver.d_length;
 
 		if(solver.m_solvers[DIM_X] && !solver.m_solvers[DIM_X]->d_frame)
+		{
 			d_position = d_position + solver.m_solvers[DIM_X]->d_position;
+			this->invalidateTransform();
+			this->markMoved();
+		}
 	}
 
 	void Frame::debugPrintDepth()
@@ -66,6 +66,9 @@ namespace toy
 		DirtyLayout clearDirty() { DirtyLayout dirty = d_dirty; d_dirty = CLEAN; return dirty; }
 		void setDirty(DirtyLayout dirty) { if(dirty > d_dirty) d_dirty = dirty; }
 		void markDirty(DirtyLayout dirty);
+		void markRepaint();
+		void markMoved();
+		void markIndexDirty();
 
 		using Filter = std::function<bool(Frame&)>;
 		virtual Frame* pinpoint(DimFloat pos, const Filter& filter = nullptr);
@@ -75,6 +78,7 @@ namespace toy
 		void setStyle(Style& style, bool reset = false);
 		void updateStyle(bool reset = false);
 		void updateInkstyle(InkStyle& inkstyle);
+		void reloadStyle(const InkStyle& previous, StyleChange change);
 
 		void setSizeDim(Dimension dim, float size);
 		void setSpanDim(Dimension dim, float span);
@@ -83,19 +87,28 @@ namespace toy
 		inline void setPosition(const DimFloat& pos) { setPositionDim(DIM_X, pos.x), setPositionDim(DIM_Y, pos.y); }
 		inline void setSize(const DimFloat& size) { setSizeDim(DIM_X, size.x); setSizeDim(DIM_Y, size.y); }
 
+		// overlays are drawn from their position every frame : moving them marks nothing dirty
+		void setOverlayPosition(const DimFloat& pos);
+
+		void setScale(float scale);
+
 		// global to local
 		void integratePosition(Frame& root, DimFloat& global);
 		inline DimFloat integratePosition(const DimFloat& pos, Frame& root) { DimFloat local = pos; integratePosition(root, local); return local; }
-		inline DimFloat localPosition(const DimFloat& pos) { return integratePosition(pos, lookup(MASTER_LAYER)); }
+		inline DimFloat localPosition(const DimFloat& pos) { updateTransform(); return { (pos.x - d_absoluteOffset.x) / d_offsetScale, (pos.y - d_absoluteOffset.y) / d_offsetScale }; }
 
 		// local to global
 		void derivePosition(Frame& root, DimFloat& local);
 		inline DimFloat derivePosition(const DimFloat& pos, Frame& root) { DimFloat local = pos; derivePosition(root, local); return local; }
-		inline DimFloat derivePosition(const DimFloat& pos) { return derivePosition(pos, lookup(MASTER_LAYER)); }
+		inline DimFloat derivePosition(const DimFloat& pos) { updateTransform(); return { d_absoluteOffset.x + pos.x * d_offsetScale, d_absoluteOffset.y + pos.y * d_offsetScale }; }
 		inline DimFloat absolutePosition() { return derivePosition({ 0.f, 0.f }); }
 
 		float deriveScale(Frame& root);
-		inline float absoluteScale() { return this->deriveScale(lookup(MASTER_LAYER)); }
+		inline float absoluteScale() { updateTransform(); return d_absoluteScale; }
+
+		// absolute transform to the master layer, cached per frame until the frame or one of its ancestors moves or scales
+		void updateTransform();
+		void invalidateTransform() { d_transformDirty = true; }
 
 		bool inside(const DimFloat& pos);
 
@@ -121,6 +134,7 @@ namespace toy
 		Frame* d_parent;
 		DirtyLayout d_dirty;
 		bool d_hidden;
+		bool d_overlay;
 		Dim<size_t> d_index;
 
 		BoxFloat d_hardClip;
@@ -131,6 +145,16 @@ namespace toy
 		Style* d_style;
 		InkStyle* d_inkstyle;
 
+		DimFloat d_absoluteOffset;
+		float d_offsetScale;
+		float d_absoluteScale;
+		// version of the cached transform, and the version of the parent transform it was derived from
+		size_t d_transformStamp;
+		size_t d_parentStamp;
+		bool d_transformDirty;
+
+		static size_t s_transformStamp;
+
 	public:
 		object_ptr<Caption> d_caption;
 		object_ptr<Icon> d_icon;
@@ -0,0 +1,131 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#include <toyui/Config.h>
+#include <toyui/Frame/Highlighter.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace toy
+{
+	Highlighter::Highlighter(Lexer& lexer)
+		: m_lexer(lexer)
+		, m_shiftFrom(0)
+		, m_shift(0)
+	{}
+
+	uint32_t Highlighter::lexLine(const string& text, size_t start, uint32_t state, HighlightLine& line)
+	{
+		size_t end = text.find('\n', start);
+		if(end == string::npos)
+			end = text.size();
+
+		line.m_start = start;
+		line.m_end = end;
+		line.m_spans.clear();
+		line.m_state = m_lexer.lexLine(text.c_str() + start, text.c_str() + end, state, line.m_spans);
+		return line.m_state;
+	}
+
+	void Highlighter::lex(const string& text)
+	{
+		m_lines.clear();
+		m_shiftFrom = 0;
+		m_shift = 0;
+
+		uint32_t state = 0;
+		size_t start = 0;
+		do
+		{
+			m_lines.emplace_back();
+			state = this->lexLine(text, start, state, m_lines.back());
+			start = m_lines.back().m_end + 1;
+		}
+		while(start <= text.size());
+	}
+
+	void Highlighter::edit(const string& text, size_t offset, size_t erased, size_t inserted)
+	{
+		if(m_lines.empty())
+			return this->lex(text);
+
+		size_t first = this->lineIndex(offset);
+		size_t last = this->lineIndex(offset + erased);
+		size_t delta = inserted - erased; // wraps around on removal, which unsigned arithmetic undoes
+
+		// the edited lines get their actual offsets, the following ones take the edit delta through the pending shift
+		this->moveShift(last + 1);
+
+		uint32_t previousState = m_lines[last].m_state;
+		size_t editEnd = m_lines[last].m_end + delta;
+		m_shift += delta;
+
+		// re-lex the lines covering the edit
+		uint32_t state = first > 0 ? m_lines[first - 1].m_state : 0;
+		size_t start = m_lines[first].m_start;
+
+		m_edited.clear();
+		do
+		{
+			m_edited.emplace_back();
+			state = this->lexLine(text, start, state, m_edited.back());
+			start = m_edited.back().m_end + 1;
+		}
+		while(m_edited.back().m_end < editEnd);
+
+		size_t replaced = last - first + 1;
+		size_t count = m_edited.size();
+
+		for(size_t i = 0; i < std::min(replaced, count); ++i)
+			std::swap(m_lines[first + i], m_edited[i]);
+
+		if(count > replaced)
+			m_lines.insert(m_lines.begin() + first + replaced, std::make_move_iterator(m_edited.begin() + replaced), std::make_move_iterator(m_edited.end()));
+		else if(count < replaced)
+			m_lines.erase(m_lines.begin() + first + count, m_lines.begin() + first + replaced);
+
+		m_shiftFrom = first + count;
+
+		// the following lines only need lexing until one of them ends in the same state as before
+		if(state == previousState)
+			return;
+
+		for(size_t i = first + count; i < m_lines.size(); ++i)
+		{
+			this->moveShift(i + 1);
+			HighlightLine& line = m_lines[i];
+			uint32_t before = line.m_state;
+			state = this->lexLine(text, line.m_start, state, line);
+			if(state == before)
+				break;
+		}
+	}
+
+	void Highlighter::moveShift(size_t index)
+	{
+		index = std::min(index, m_lines.size());
+		if(m_shift != 0)
+		{
+			for(size_t i = m_shiftFrom; i < index; ++i)
+			{
+				m_lines[i].m_start += m_shift;
+				m_lines[i].m_end += m_shift;
+			}
+			for(size_t i = index; i < m_shiftFrom; ++i)
+			{
+				m_lines[i].m_start -= m_shift;
+				m_lines[i].m_end -= m_shift;
+			}
+		}
+		m_shiftFrom = index;
+	}
+
+	size_t Highlighter::lineIndex(size_t offset)
+	{
+		const HighlightLine* lines = m_lines.data();
+		auto it = std::upper_bound(m_lines.begin(), m_lines.end(), offset, [this, lines](size_t offset, const HighlightLine& line) { return offset < this->lineStart(&line - lines); });
+		return it == m_lines.begin() ? 0 : (it - m_lines.begin()) - 1;
+	}
+}
@@ -0,0 +1,72 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#ifndef TOY_HIGHLIGHTER_H
+#define TOY_HIGHLIGHTER_H
+
+/* toy */
+#include <toyobj/Util/NonCopy.h>
+#include <toyui/Types.h>
+
+/* std */
+#include <cstdint>
+
+namespace toy
+{
+	struct TOY_UI_EXPORT TextSpan
+	{
+		size_t start; // offset relative to the line start
+		size_t end;
+		InkStyle* style;
+	};
+
+	class TOY_UI_EXPORT Lexer
+	{
+	public:
+		virtual ~Lexer() {}
+
+		// Lexes one line (without its newline) entered in a given state : spans are appended in order, the returned state is the one the line ends in
+		virtual uint32_t lexLine(const char* start, const char* end, uint32_t state, std::vector<TextSpan>& spans) = 0;
+	};
+
+	struct TOY_UI_EXPORT HighlightLine
+	{
+		size_t m_start;
+		size_t m_end;
+		uint32_t m_state;
+		std::vector<TextSpan> m_spans;
+	};
+
+	class TOY_UI_EXPORT Highlighter : public NonCopy
+	{
+	public:
+		Highlighter(Lexer& lexer);
+
+		void lex(const string& text);
+		void edit(const string& text, size_t offset, size_t erased, size_t inserted);
+
+		size_t lineIndex(size_t offset);
+
+		// text offsets of a line, with the pending shift applied
+		size_t lineStart(size_t index) const { return m_lines[index].m_start + (index >= m_shiftFrom ? m_shift : 0); }
+		size_t lineEnd(size_t index) const { return m_lines[index].m_end + (index >= m_shiftFrom ? m_shift : 0); }
+
+	protected:
+		uint32_t lexLine(const string& text, size_t start, uint32_t state, HighlightLine& line);
+		void moveShift(size_t index);
+
+	public:
+		Lexer& m_lexer;
+		std::vector<HighlightLine> m_lines;
+
+	protected:
+		std::vector<HighlightLine> m_edited;
+
+		// the lines from m_shiftFrom on are offset by m_shift : an edit only moves that boundary across the lines between it and the previous edit
+		size_t m_shiftFrom;
+		size_t m_shift;
+	};
+}
+
+#endif
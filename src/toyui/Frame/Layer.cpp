@@ -9,6 +9,10 @@
 #include <toyui/Widget/Sheet.h>
 #include <toyobj/Iterable/Reverse.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 namespace toy
 {
 	Layer::Layer(Wedge& wedge, FrameType layerType)
@@ -18,6 +22,8 @@ namespace toy
 		, d_z(0)
 		, d_redraw(REDRAW)
 		, d_layerType(layerType)
+		, d_indexDirty(true)
+		, d_hitGrid(0, 0)
 	{}
 
 	Layer::~Layer()
@@ -85,7 +91,206 @@ namespace toy
 				return target;
 		}
 
-		return Frame::pinpoint(pos, filter);
+		return this->pinpointIndex(pos, filter);
+	}
+
+	void Layer::indexFrame(Frame& frame, const DimFloat& position, float scale, BoxFloat clip, std::vector<HitEntry>& entries)
+	{
+		if(frame.d_hidden || frame.hollow())
+			return;
+
+		BoxFloat bounds(position.x, position.y, position.x + frame.m_size.x * scale, position.y + frame.m_size.y * scale);
+		if(frame.clip())
+			clip.assign(std::max(clip.x0, bounds.x0), std::max(clip.y0, bounds.y0), std::min(clip.x1, bounds.x1), std::min(clip.y1, bounds.y1));
+
+		if(clip.x0 > clip.x1 || clip.y0 > clip.y1)
+			return;
+
+		BoxFloat hit(std::max(bounds.x0, clip.x0), std::max(bounds.y0, clip.y0), std::min(bounds.x1, clip.x1), std::min(bounds.y1, clip.y1));
+
+		size_t index = entries.size();
+		entries.push_back({ &frame, bounds, hit, clip, scale, 0 });
+
+		if(frame.d_wedge)
+			for(Widget* widget : frame.d_wedge->m_contents)
+			{
+				Frame& child = widget->frame();
+				// sublayers are hit-tested first, through their own index
+				if(child.frameType() >= LAYER)
+					continue;
+
+				DimFloat childPosition = { position.x + child.d_position.x * scale, position.y + child.d_position.y * scale };
+				this->indexFrame(child, childPosition, scale * child.d_scale, clip, entries);
+			}
+
+		entries[index].end = uint32_t(entries.size());
+	}
+
+	void Layer::updateIndex()
+	{
+		d_indexDirty = false;
+		d_hitMoved.clear();
+		d_hitEntries.clear();
+		d_hitIndex.clear();
+
+		// entries are collected in depth-first order, so that among the frames under a point the last one is the one pinpoint would find
+		float unbounded = std::numeric_limits<float>::max();
+		BoxFloat everything(-unbounded, -unbounded, unbounded, unbounded);
+		this->indexFrame(*this, { 0.f, 0.f }, 1.f, everything, d_hitEntries);
+
+		if(d_hitEntries.empty())
+			return;
+
+		d_hitBounds = d_hitEntries.front().clip;
+		for(uint32_t i = 0; i < d_hitEntries.size(); ++i)
+		{
+			HitEntry& entry = d_hitEntries[i];
+			d_hitIndex[entry.frame] = i;
+			d_hitBounds.assign(std::min(d_hitBounds.x0, entry.clip.x0), std::min(d_hitBounds.y0, entry.clip.y0), std::max(d_hitBounds.x1, entry.clip.x1), std::max(d_hitBounds.y1, entry.clip.y1));
+		}
+
+		// uniform grid : each cell lists the entries whose clipped bounds overlap it, in depth-first order
+		size_t side = std::min(size_t(64), std::max(size_t(1), size_t(std::sqrt(float(d_hitEntries.size())))));
+		d_hitGrid = { side, side };
+		d_hitCellSize = { std::max(1.f, (d_hitBounds.x1 - d_hitBounds.x0) / side), std::max(1.f, (d_hitBounds.y1 - d_hitBounds.y0) / side) };
+
+		d_hitCells.resize(d_hitGrid.x * d_hitGrid.y);
+		for(std::vector<uint32_t>& cell : d_hitCells)
+			cell.clear();
+
+		for(uint32_t i = 0; i < d_hitEntries.size(); ++i)
+			this->listEntry(i);
+	}
+
+	void Layer::listEntry(uint32_t index)
+	{
+		const BoxFloat& box = d_hitEntries[index].clip;
+		size_t cx0 = std::min(d_hitGrid.x - 1, size_t((box.x0 - d_hitBounds.x0) / d_hitCellSize.x));
+		size_t cy0 = std::min(d_hitGrid.y - 1, size_t((box.y0 - d_hitBounds.y0) / d_hitCellSize.y));
+		size_t cx1 = std::min(d_hitGrid.x - 1, size_t((box.x1 - d_hitBounds.x0) / d_hitCellSize.x));
+		size_t cy1 = std::min(d_hitGrid.y - 1, size_t((box.y1 - d_hitBounds.y0) / d_hitCellSize.y));
+
+		// cells are kept sorted by entry, so that the depth-first order holds after in place updates
+		for(size_t y = cy0; y <= cy1; ++y)
+			for(size_t x = cx0; x <= cx1; ++x)
+			{
+				std::vector<uint32_t>& cell = d_hitCells[y * d_hitGrid.x + x];
+				cell.insert(std::lower_bound(cell.begin(), cell.end(), index), index);
+			}
+	}
+
+	void Layer::unlistEntry(uint32_t index)
+	{
+		const BoxFloat& box = d_hitEntries[index].clip;
+		size_t cx0 = std::min(d_hitGrid.x - 1, size_t((box.x0 - d_hitBounds.x0) / d_hitCellSize.x));
+		size_t cy0 = std::min(d_hitGrid.y - 1, size_t((box.y0 - d_hitBounds.y0) / d_hitCellSize.y));
+		size_t cx1 = std::min(d_hitGrid.x - 1, size_t((box.x1 - d_hitBounds.x0) / d_hitCellSize.x));
+		size_t cy1 = std::min(d_hitGrid.y - 1, size_t((box.y1 - d_hitBounds.y0) / d_hitCellSize.y));
+
+		for(size_t y = cy0; y <= cy1; ++y)
+			for(size_t x = cx0; x <= cx1; ++x)
+			{
+				std::vector<uint32_t>& cell = d_hitCells[y * d_hitGrid.x + x];
+				auto it = std::lower_bound(cell.begin(), cell.end(), index);
+				if(it != cell.end() && *it == index)
+					cell.erase(it);
+			}
+	}
+
+	bool Layer::reindexFrame(Frame& frame)
+	{
+		auto it = d_hitIndex.find(&frame);
+		if(it == d_hitIndex.end())
+			return false;
+
+		uint32_t begin = (*it).second;
+
+		DimFloat position = { 0.f, 0.f };
+		float scale = 1.f;
+		float unbounded = std::numeric_limits<float>::max();
+		BoxFloat clip(-unbounded, -unbounded, unbounded, unbounded);
+
+		if(&frame != this)
+		{
+			auto parentIt = d_hitIndex.find(frame.d_parent);
+			if(parentIt == d_hitIndex.end())
+				return false;
+
+			HitEntry& parent = d_hitEntries[(*parentIt).second];
+			position = { parent.bounds.x0 + frame.d_position.x * parent.scale, parent.bounds.y0 + frame.d_position.y * parent.scale };
+			scale = parent.scale * frame.d_scale;
+			clip = parent.inherited;
+		}
+
+		d_hitScratch.clear();
+		this->indexFrame(frame, position, scale, clip, d_hitScratch);
+
+		// the subtree must keep the same frames : anything shown, hidden or clipped out by the move takes a full rebuild
+		uint32_t end = d_hitEntries[begin].end;
+		if(d_hitScratch.size() != end - begin)
+			return false;
+		for(uint32_t i = 0; i < d_hitScratch.size(); ++i)
+			if(d_hitScratch[i].frame != d_hitEntries[begin + i].frame)
+				return false;
+
+		for(uint32_t i = 0; i < d_hitScratch.size(); ++i)
+		{
+			HitEntry& updated = d_hitScratch[i];
+			updated.end += begin;
+
+			HitEntry& entry = d_hitEntries[begin + i];
+			bool moved = !(entry.clip.x0 == updated.clip.x0 && entry.clip.y0 == updated.clip.y0 && entry.clip.x1 == updated.clip.x1 && entry.clip.y1 == updated.clip.y1);
+			if(moved && (updated.clip.x0 < d_hitBounds.x0 || updated.clip.y0 < d_hitBounds.y0 || updated.clip.x1 > d_hitBounds.x1 || updated.clip.y1 > d_hitBounds.y1))
+				return false;
+
+			if(moved)
+				this->unlistEntry(begin + i);
+			entry = updated;
+			if(moved)
+				this->listEntry(begin + i);
+		}
+
+		return true;
+	}
+
+	void Layer::updateMoved()
+	{
+		// past a fraction of the entries, rebuilding is cheaper than patching overlapping subtrees
+		if(d_hitMoved.size() > d_hitEntries.size() / 4)
+			d_indexDirty = true;
+
+		for(Frame* frame : d_hitMoved)
+			if(d_indexDirty || !this->reindexFrame(*frame))
+			{
+				d_indexDirty = true;
+				break;
+			}
+
+		d_hitMoved.clear();
+	}
+
+	Frame* Layer::pinpointIndex(const DimFloat& pos, const Filter& filter)
+	{
+		if(!d_indexDirty && !d_hitMoved.empty())
+			this->updateMoved();
+		if(d_indexDirty)
+			this->updateIndex();
+
+		if(d_hitEntries.empty() || pos.x < d_hitBounds.x0 || pos.x > d_hitBounds.x1 || pos.y < d_hitBounds.y0 || pos.y > d_hitBounds.y1)
+			return nullptr;
+
+		size_t x = std::min(d_hitGrid.x - 1, size_t((pos.x - d_hitBounds.x0) / d_hitCellSize.x));
+		size_t y = std::min(d_hitGrid.y - 1, size_t((pos.y - d_hitBounds.y0) / d_hitCellSize.y));
+		std::vector<uint32_t>& cell = d_hitCells[y * d_hitGrid.x + x];
+
+		for(size_t i = cell.size(); i > 0; --i)
+		{
+			HitEntry& entry = d_hitEntries[cell[i - 1]];
+			if(pos.x >= entry.clip.x0 && pos.x <= entry.clip.x1 && pos.y >= entry.clip.y0 && pos.y <= entry.clip.y1 && filter(*entry.frame))
+				return entry.frame;
+		}
+
+		return nullptr;
 	}
 
 	void Layer::visit(const Visitor& visitor)
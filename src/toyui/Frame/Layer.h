@@ -8,6 +8,10 @@
 /* toy */
 #include <toyui/Frame/Frame.h>
 
+/* std */
+#include <cstdint>
+#include <unordered_map>
+
 namespace toy
 {
 	class _refl_ TOY_UI_EXPORT Layer : public Frame
@@ -51,6 +55,29 @@ namespace toy
 
 		Frame* pinpoint(DimFloat pos, const Filter& filter);
 
+		void setIndexDirty() { d_indexDirty = true; }
+		void moveIndexed(Frame& frame) { if(!d_indexDirty) d_hitMoved.push_back(&frame); }
+		void updateIndex();
+
+	protected:
+		// frame bounds and clip bounds are both stored as corners (x0, y0, x1, y1) in the layer space
+		struct HitEntry
+		{
+			Frame* frame;
+			BoxFloat bounds;
+			BoxFloat clip;		// the bounds where the frame can be hit
+			BoxFloat inherited;	// the clip passed down to the children
+			float scale;
+			uint32_t end;		// one past the last entry of the frame subtree
+		};
+
+		void indexFrame(Frame& frame, const DimFloat& position, float scale, BoxFloat clip, std::vector<HitEntry>& entries);
+		bool reindexFrame(Frame& frame);
+		void updateMoved();
+		void listEntry(uint32_t index);
+		void unlistEntry(uint32_t index);
+		Frame* pinpointIndex(const DimFloat& pos, const Filter& filter);
+
 	protected:
 		Layer* d_parentLayer;
 		size_t d_index;
@@ -61,6 +88,16 @@ namespace toy
 		std::vector<Layer*> d_sublayers;
 
 		FrameType d_layerType;
+
+		bool d_indexDirty;
+		std::vector<HitEntry> d_hitEntries;
+		std::unordered_map<Frame*, uint32_t> d_hitIndex;
+		std::vector<Frame*> d_hitMoved;
+		std::vector<HitEntry> d_hitScratch;
+		BoxFloat d_hitBounds;
+		Dim<size_t> d_hitGrid;
+		DimFloat d_hitCellSize;
+		std::vector<std::vector<uint32_t>> d_hitCells;
 	};
 }
 
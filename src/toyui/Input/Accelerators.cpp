@@ -0,0 +1,122 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#include <toyui/Config.h>
+#include <toyui/Input/Accelerators.h>
+
+#include <toyui/Widget/Sheet.h>
+#include <toyui/Button/Button.h>
+
+namespace toy
+{
+	AcceleratorTable::AcceleratorTable()
+	{}
+
+	void AcceleratorTable::bind(InputModifier modifiers, KeyCode key, const Handler& handler, Widget* scope, Widget* owner)
+	{
+		this->unbind(modifiers, key, scope);
+
+		m_bindings[combo(modifiers, key)].push_back({ scope, owner, handler });
+		this->reference(scope);
+		this->reference(owner);
+	}
+
+	void AcceleratorTable::unbind(InputModifier modifiers, KeyCode key, Widget* scope)
+	{
+		auto it = m_bindings.find(combo(modifiers, key));
+		if(it == m_bindings.end())
+			return;
+
+		std::vector<Binding>& bindings = (*it).second;
+		for(size_t i = 0; i < bindings.size(); ++i)
+			if(bindings[i].m_scope == scope)
+			{
+				this->release(bindings[i].m_scope);
+				this->release(bindings[i].m_owner);
+				bindings.erase(bindings.begin() + i);
+				break;
+			}
+
+		if(bindings.empty())
+			m_bindings.erase(it);
+	}
+
+	void AcceleratorTable::bindItem(ClickTrigger& item, InputModifier modifiers, KeyCode key, Widget* scope)
+	{
+		this->bind(modifiers, key, [&item]() { if(item.m_trigger) item.m_trigger(item.m_widget); }, scope, &item.m_widget);
+	}
+
+	void AcceleratorTable::unbind(Widget& widget)
+	{
+		if(m_widgets.find(&widget) == m_widgets.end())
+			return;
+
+		for(auto it = m_bindings.begin(); it != m_bindings.end();)
+		{
+			std::vector<Binding>& bindings = (*it).second;
+			for(int i = bindings.size() - 1; i >= 0; --i)
+				if(bindings[i].m_scope == &widget || bindings[i].m_owner == &widget)
+				{
+					this->release(bindings[i].m_scope);
+					this->release(bindings[i].m_owner);
+					bindings.erase(bindings.begin() + i);
+				}
+
+			if(bindings.empty())
+				it = m_bindings.erase(it);
+			else
+				++it;
+		}
+	}
+
+	bool AcceleratorTable::dispatch(InputModifier modifiers, KeyCode key, Widget* focused)
+	{
+		auto it = m_bindings.find(combo(modifiers, key));
+		if(it == m_bindings.end())
+			return false;
+
+		std::vector<Binding>& bindings = (*it).second;
+
+		const Binding* match = nullptr;
+		for(Widget* scope = focused; scope && !match; scope = scope->m_parent)
+			for(const Binding& binding : bindings)
+				if(binding.m_scope == scope)
+				{
+					match = &binding;
+					break;
+				}
+
+		if(!match)
+			for(const Binding& binding : bindings)
+				if(!binding.m_scope)
+				{
+					match = &binding;
+					break;
+				}
+
+		if(!match)
+			return false;
+
+		// the handler may rebind shortcuts, invalidating the binding
+		Handler handler = match->m_handler;
+		handler();
+		return true;
+	}
+
+	void AcceleratorTable::reference(Widget* widget)
+	{
+		if(widget)
+			++m_widgets[widget];
+	}
+
+	void AcceleratorTable::release(Widget* widget)
+	{
+		if(!widget)
+			return;
+
+		auto it = m_widgets.find(widget);
+		if(it != m_widgets.end() && --(*it).second == 0)
+			m_widgets.erase(it);
+	}
+}
@@ -0,0 +1,62 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#ifndef TOY_ACCELERATORS_H
+#define TOY_ACCELERATORS_H
+
+/* toy */
+#include <toyobj/Util/NonCopy.h>
+#include <toyui/Types.h>
+#include <toyui/Input/KeyCode.h>
+#include <toyui/Input/InputDispatcher.h>
+
+/* std */
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace toy
+{
+	class ClickTrigger;
+
+	// Keyboard shortcuts, hashed by modifiers and key, resolved by the root sheet before the key event is propagated to any widget
+	// A shortcut bound with a scope only fires when the focused widget lies inside that scope (typically a Window or a Dockspace section) : the innermost scope wins over the outer ones and over global shortcuts
+	class TOY_UI_EXPORT AcceleratorTable : public NonCopy
+	{
+	public:
+		typedef std::function<void()> Handler;
+
+		AcceleratorTable();
+
+		void bind(InputModifier modifiers, KeyCode key, const Handler& handler, Widget* scope = nullptr, Widget* owner = nullptr);
+		void unbind(InputModifier modifiers, KeyCode key, Widget* scope = nullptr);
+
+		// binds a menu or toolbar item : the shortcut fires the item trigger directly, without walking the menus
+		void bindItem(ClickTrigger& item, InputModifier modifiers, KeyCode key, Widget* scope = nullptr);
+
+		// removes the shortcuts scoped to or owned by the widget
+		void unbind(Widget& widget);
+
+		bool dispatch(InputModifier modifiers, KeyCode key, Widget* focused);
+
+		static uint64_t combo(InputModifier modifiers, KeyCode key) { return (uint64_t) modifiers << 32 | key; }
+
+	protected:
+		struct Binding
+		{
+			Widget* m_scope;
+			Widget* m_owner;
+			Handler m_handler;
+		};
+
+		void reference(Widget* widget);
+		void release(Widget* widget);
+
+		std::unordered_map<uint64_t, std::vector<Binding>> m_bindings;
+		std::unordered_map<Widget*, size_t> m_widgets; // number of bindings referencing each widget, so that destroying any other widget is a single lookup
+	};
+}
+
+#endif // TOY_ACCELERATORS_H
@@ -0,0 +1,85 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#ifndef TOY_INLINEVECTOR_H
+#define TOY_INLINEVECTOR_H
+
+/* std */
+#include <cstddef>
+#include <vector>
+
+namespace toy
+{
+	// A vector of trivial elements storing its first N elements inline
+	// It only touches the heap past N elements, and keeps that storage around once spilled so that a reused instance stops allocating
+	template <class T, size_t N>
+	class InlineVector
+	{
+	public:
+		InlineVector() : m_size(0), m_spilled(false) {}
+		InlineVector(const InlineVector& other) : m_size(0), m_spilled(false) { *this = other; }
+
+		InlineVector& operator=(const InlineVector& other)
+		{
+			if(&other == this)
+				return *this;
+			this->clear();
+			for(const T& value : other)
+				this->push_back(value);
+			return *this;
+		}
+
+		void push_back(const T& value)
+		{
+			if(!m_spilled && m_size == N)
+			{
+				m_heap.assign(m_inline, m_inline + N);
+				m_spilled = true;
+			}
+
+			if(m_spilled)
+				m_heap.push_back(value);
+			else
+				m_inline[m_size] = value;
+			++m_size;
+		}
+
+		void erase(size_t index)
+		{
+			T* values = this->data();
+			for(size_t i = index; i + 1 < m_size; ++i)
+				values[i] = values[i + 1];
+			if(m_spilled)
+				m_heap.pop_back();
+			--m_size;
+		}
+
+		void clear() { m_heap.clear(); m_size = 0; m_spilled = false; }
+
+		T* data() { return m_spilled ? m_heap.data() : m_inline; }
+		const T* data() const { return m_spilled ? m_heap.data() : m_inline; }
+
+		size_t size() const { return m_size; }
+		bool empty() const { return m_size == 0; }
+
+		T& operator[](size_t index) { return this->data()[index]; }
+		const T& operator[](size_t index) const { return this->data()[index]; }
+
+		T& front() { return this->data()[0]; }
+		T& back() { return this->data()[m_size - 1]; }
+
+		T* begin() { return this->data(); }
+		T* end() { return this->data() + m_size; }
+		const T* begin() const { return this->data(); }
+		const T* end() const { return this->data() + m_size; }
+
+	protected:
+		T m_inline[N];
+		std::vector<T> m_heap;
+		size_t m_size;
+		bool m_spilled;
+	};
+}
+
+#endif // TOY_INLINEVECTOR_H
@@ -10,6 +10,8 @@
 #include <toyui/Widget/RootSheet.h>
 #include <toyui/Widget/Cursor.h>
 
+#include <algorithm>
+
 namespace toy
 {
 	InputDevice::InputDevice(RootSheet& rootSheet)
@@ -21,16 +23,34 @@ namespace toy
 		: InputDevice(rootSheet)
 		, m_shiftPressed(false)
 		, m_ctrlPressed(false)
+		, m_altPressed(false)
 	{}
 
+	InputModifier Keyboard::modifiers()
+	{
+		return static_cast<InputModifier>((m_shiftPressed ? INPUT_SHIFT : 0) | (m_ctrlPressed ? INPUT_CTRL : 0) | (m_altPressed ? INPUT_ALT : 0));
+	}
+
 	void Keyboard::dispatchKeyPressed(KeyCode key, char c)
 	{
+		m_rootSheet.m_mouse.flushMouseMoved();
+
 		/*if(key == KC_ESCAPE)
 			m_shutdownRequested = true;
 		else */if(key == KC_LSHIFT || key == KC_RSHIFT)
 			m_shiftPressed = true;
 		else if(key == KC_LCONTROL || key == KC_RCONTROL)
 			m_ctrlPressed = true;
+		else if(key == KC_LMENU || key == KC_RMENU)
+			m_altPressed = true;
+
+		// a modal controller (an open popup, a text being typed in) gets every key, accelerators only apply outside of it
+		Widget* focused = m_rootSheet.m_active ? m_rootSheet.m_active : m_rootSheet.m_cursor.m_hovered;
+		if(!m_rootFrame.modal(DEVICE_KEYBOARD) && m_rootSheet.m_accelerators.dispatch(this->modifiers(), key, focused))
+		{
+			m_swallowed.push_back(key);
+			return;
+		}
 
 		KeyDownEvent keyEvent(key, c);
 		m_rootFrame.dispatchEvent(keyEvent);
@@ -38,10 +58,21 @@ namespace toy
 
 	void Keyboard::dispatchKeyReleased(KeyCode key, char c)
 	{
+		m_rootSheet.m_mouse.flushMouseMoved();
+
 		if(key == KC_LSHIFT || key == KC_RSHIFT)
 			m_shiftPressed = false;
 		else if(key == KC_LCONTROL || key == KC_RCONTROL)
 			m_ctrlPressed = false;
+		else if(key == KC_LMENU || key == KC_RMENU)
+			m_altPressed = false;
+
+		auto swallowed = std::find(m_swallowed.begin(), m_swallowed.end(), key);
+		if(swallowed != m_swallowed.end())
+		{
+			m_swallowed.erase(swallowed);
+			return;
+		}
 
 		KeyUpEvent keyEvent(key, c);
 		m_rootFrame.dispatchEvent(keyEvent);
@@ -53,24 +84,36 @@ namespace toy
 					   MouseButton{ *this, DEVICE_MOUSE_RIGHT_BUTTON },
 					   MouseButton{ *this, DEVICE_MOUSE_MIDDLE_BUTTON } } }
 		, m_lastPos(0.f, 0.f)
+		, m_hoverGeneration(1)
+		, m_movePending(false)
+		, m_movePos(0.f, 0.f)
 	{}
 
-	void Mouse::mouseFocus(DimFloat pos, std::vector<Widget*>& focused)
+	void Mouse::mouseFocus(DimFloat pos, const WidgetChain& focused)
 	{
-		if(focused.size() > 0)
-			m_rootSheet.m_cursor.hover(*focused.front());
+		if(!focused.empty())
+			m_rootSheet.m_cursor.hover(*focused[0]);
 		else
 			m_rootSheet.m_cursor.unhover();
 
 		MouseEnterEvent mouseEnterEvent(*this, pos);
 		MouseLeaveEvent mouseLeaveEvent(*this, pos);
 
+		size_t previous = m_hoverGeneration++;
+		size_t current = m_hoverGeneration;
+
 		for(Widget* newFocus : focused)
-			if(std::find(m_focused.begin(), m_focused.end(), newFocus) == m_focused.end())
+		{
+			if(newFocus->m_hoverStamp == current)
+				continue;
+			bool entered = newFocus->m_hoverStamp != previous;
+			newFocus->m_hoverStamp = current;
+			if(entered)
 				newFocus->receiveEvent(mouseEnterEvent);
+		}
 
 		for(Widget* oldFocus : m_focused)
-			if(std::find(focused.begin(), focused.end(), oldFocus) == focused.end())
+			if(oldFocus->m_hoverStamp != current)
 				oldFocus->receiveEvent(mouseLeaveEvent);
 
 		m_focused = focused;
@@ -86,8 +129,27 @@ namespace toy
 			mouseEvent.m_modifiers = static_cast<InputModifier>(mouseEvent.m_modifiers ^ INPUT_CTRL);
 	}
 
+	void Mouse::queueMouseMoved(DimFloat pos)
+	{
+		m_movePending = true;
+		m_movePos = pos;
+		m_moveSamples.push_back(pos);
+	}
+
+	void Mouse::flushMouseMoved()
+	{
+		if(!m_movePending)
+			return;
+
+		// the delta of the dispatched move accumulates all the samples since the last dispatch
+		this->dispatchMouseMoved(m_movePos);
+		m_moveSamples.clear();
+	}
+
 	void Mouse::dispatchMouseMoved(DimFloat pos)
 	{
+		m_movePending = false;
+
 		MouseMoveEvent mouseEvent(*this, pos);
 
 		m_lastPos = mouseEvent.m_pos;
@@ -103,16 +165,19 @@ namespace toy
 
 	void Mouse::dispatchMousePressed(DimFloat pos, MouseButtonCode button)
 	{
+		this->flushMouseMoved();
 		m_buttons[button].mousePressed(pos);
 	}
 
 	void Mouse::dispatchMouseReleased(DimFloat pos, MouseButtonCode button)
 	{
+		this->flushMouseMoved();
 		m_buttons[button].mouseReleased(pos);
 	}
 
 	void Mouse::dispatchMouseWheeled(DimFloat pos, float amount)
 	{
+		this->flushMouseMoved();
 		MouseWheelEvent mouseEvent(*this, pos, amount);
 		m_rootFrame.dispatchEvent(mouseEvent);
 	}
@@ -120,8 +185,8 @@ namespace toy
 	void Mouse::handleDestroyWidget(Widget& widget)
 	{
 		for(int i = m_focused.size() - 1; i >= 0; --i)
-			if(m_focused.at(i) == &widget)
-				m_focused.erase(m_focused.begin() + i);
+			if(m_focused[i] == &widget)
+				m_focused.erase(i);
 	}
 
 	MouseButton::MouseButton(Mouse& mouse, DeviceType deviceType)
@@ -35,9 +35,15 @@ namespace toy
 		void dispatchKeyPressed(KeyCode key, char c);
 		void dispatchKeyReleased(KeyCode key, char c);
 
+		InputModifier modifiers();
+
 	public:
 		bool m_shiftPressed;
 		bool m_ctrlPressed;
+		bool m_altPressed;
+
+		// keys whose press triggered an accelerator : their release is not dispatched either
+		std::vector<KeyCode> m_swallowed;
 	};
 
 	class TOY_UI_EXPORT MouseButton : public InputDevice
@@ -77,7 +83,12 @@ namespace toy
 		void dispatchMouseReleased(DimFloat pos, MouseButtonCode button);
 		void dispatchMouseWheeled(DimFloat pos, float amount);
 
-		void mouseFocus(DimFloat pos, std::vector<Widget*>& inputFrame);
+		// motion is buffered and dispatched as a single move per frame : the raw samples stay available in m_moveSamples during that dispatch
+		void queueMouseMoved(DimFloat pos);
+		void flushMouseMoved();
+
+		// hovered widgets are stamped with the generation of the last focus pass, so entering and leaving is diffed in linear time
+		void mouseFocus(DimFloat pos, const WidgetChain& focused);
 
 		void handleDestroyWidget(Widget& widget);
 
@@ -86,7 +97,12 @@ namespace toy
 
 		DimFloat m_lastPos;
 		
-		std::vector<Widget*> m_focused;
+		WidgetChain m_focused;
+		size_t m_hoverGeneration;
+
+		bool m_movePending;
+		DimFloat m_movePos;
+		std::vector<DimFloat> m_moveSamples;
 	};
 
 	struct TOY_UI_EXPORT MouseEvent : public InputEvent
@@ -101,22 +117,30 @@ namespace toy
 
 		MouseEvent(Mouse& mouse, DeviceType deviceType, EventType eventType, DimFloat pos)
 			: InputEvent(deviceType, eventType)
-			, m_pos(pos), m_relative{ 0.f, 0.f }, m_delta{ 0.f, 0.f }, m_deltaZ(0.f), m_pressed{ 0.f, 0.f }, m_button(NO_BUTTON)
+			, m_pos(pos), m_relative{ 0.f, 0.f }, m_delta{ 0.f, 0.f }, m_deltaZ(0.f), m_pressed{ 0.f, 0.f }, m_button(button(deviceType, NO_BUTTON))
 		{
 			mouse.transformMouseEvent(*this);
-
-			if(deviceType == DEVICE_MOUSE_LEFT_BUTTON)
-				m_button = LEFT_BUTTON;
-			else if(deviceType == DEVICE_MOUSE_RIGHT_BUTTON)
-				m_button = RIGHT_BUTTON;
-			else if(deviceType == DEVICE_MOUSE_MIDDLE_BUTTON)
-				m_button = MIDDLE_BUTTON;
 		}
 
+		// derived events copy the already transformed coordinates of their source instead of transforming again
 		MouseEvent(Mouse& mouse, DeviceType deviceType, EventType eventType, MouseEvent& source)
-			: MouseEvent(mouse, deviceType, eventType, {})
+			: InputEvent(deviceType, eventType)
+			, m_pos(source.m_pos), m_relative(source.m_relative), m_delta(source.m_delta), m_deltaZ(0.f), m_pressed(source.m_pressed), m_button(button(deviceType, source.m_button))
+		{
+			UNUSED(mouse);
+			m_modifiers = source.m_modifiers;
+		}
+
+		// the button a device stands for, or the fallback for devices which aren't a single button
+		static MouseButtonCode button(DeviceType deviceType, MouseButtonCode fallback)
 		{
-			m_pos = source.m_pos; m_relative = source.m_relative; m_delta = source.m_delta; m_pressed = source.m_pressed;
+			if(deviceType == DEVICE_MOUSE_LEFT_BUTTON)
+				return LEFT_BUTTON;
+			else if(deviceType == DEVICE_MOUSE_RIGHT_BUTTON)
+				return RIGHT_BUTTON;
+			else if(deviceType == DEVICE_MOUSE_MIDDLE_BUTTON)
+				return MIDDLE_BUTTON;
+			return fallback;
 		}
 	};
 
@@ -50,6 +50,14 @@ namespace toy
 		return filter && m_controlMode >= CM_CONTROL;
 	}
 
+	bool ControlNode::modal(DeviceType device)
+	{
+		if((m_device & device) && m_controlMode >= CM_MODAL)
+			return true;
+
+		return m_controller ? m_controller->modal(device) : false;
+	}
+
 	InputReceiver* ControlNode::dispatchEvent(InputEvent& inputEvent, InputReceiver* topReceiver)
 	{
 		if(!topReceiver)
@@ -174,6 +182,15 @@ namespace toy
 		this->debugPrint();*/
 	}
 
+	bool ControlSwitch::modal(DeviceType device)
+	{
+		for(auto& channel : m_controllers)
+			if(channel->deviceFilter() & device)
+				return channel->modal(device);
+
+		return false;
+	}
+
 /*	void ControlSwitch::debugPrint()
 	{
 		for(auto& channel : m_controllers)
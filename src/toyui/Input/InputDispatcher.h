@@ -9,6 +9,8 @@
 #include <toyobj/Object.h>
 #include <toyui/Types.h>
 #include <toyui/Input/KeyCode.h>
+#include <toyui/Input/InputQueue.h>
+#include <toyui/Input/InlineVector.h>
 
 #include <vector>
 
@@ -48,6 +50,9 @@ namespace toy
 		EVENT_DRAGGED_END
 	};
 
+	// the chain of widgets an event visits is stored inline : deep enough for any reasonable hierarchy without touching the heap
+	using WidgetChain = InlineVector<Widget*, 32>;
+
 	struct TOY_UI_EXPORT InputEvent
 	{
 		DeviceType m_deviceType;
@@ -56,7 +61,7 @@ namespace toy
 		bool m_abort;
 		InputModifier m_modifiers;
 
-		std::vector<Widget*> m_visited;
+		WidgetChain m_visited;
 
 		InputEvent(DeviceType deviceType, EventType eventType) : m_deviceType(deviceType), m_eventType(eventType), m_consumed(false), m_abort(false), m_modifiers(INPUT_NO_MOD) {}
 		virtual ~InputEvent() {}
@@ -75,6 +80,8 @@ namespace toy
 
 		float m_cursorX;
 		float m_cursorY;
+
+		InputQueue m_queue;
 	};
 
 	enum ControlMode
@@ -169,6 +176,8 @@ namespace toy
 		void yieldControl(InputReceiver& receiver);
 
 		bool controls(DeviceType device);
+		// whether a modal controller holds control of the device down the chain
+		virtual bool modal(DeviceType device);
 
 		//void debugPrint(size_t depth);
 
@@ -194,6 +203,8 @@ namespace toy
 		void takeControl(InputReceiver& receiver, ControlMode mode, DeviceType channels);
 		void yieldControl(InputReceiver& receiver);
 
+		virtual bool modal(DeviceType device);
+
 		//void debugPrint();
 
 	protected:
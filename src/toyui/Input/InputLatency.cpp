@@ -0,0 +1,80 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#include <toyui/Config.h>
+#include <toyui/Input/InputLatency.h>
+
+#include <toyui/Input/InputQueue.h>
+
+#include <algorithm>
+
+namespace toy
+{
+	InputLatency* InputLatency::s_active = nullptr;
+
+	InputLatency::InputLatency(size_t capacity)
+		: m_capacity(capacity)
+		, m_next(0)
+		, m_current(0)
+		, m_dirtied(false)
+	{
+		m_samples.reserve(capacity);
+	}
+
+	void InputLatency::beginEvent(uint64_t time)
+	{
+		m_current = time;
+		m_dirtied = false;
+		s_active = this;
+	}
+
+	void InputLatency::endEvent()
+	{
+		s_active = nullptr;
+	}
+
+	void InputLatency::dirtied()
+	{
+		if(m_dirtied)
+			return;
+
+		m_dirtied = true;
+		m_pending.push_back(m_current);
+	}
+
+	void InputLatency::presented()
+	{
+		uint64_t now = InputQueue::now();
+
+		for(uint64_t time : m_pending)
+		{
+			float latency = float(now - time) / 1000.f;
+			if(m_samples.size() < m_capacity)
+				m_samples.push_back(latency);
+			else
+				m_samples[m_next] = latency;
+			m_next = (m_next + 1) % m_capacity;
+		}
+
+		m_pending.clear();
+	}
+
+	float InputLatency::percentile(float fraction)
+	{
+		if(m_samples.empty())
+			return 0.f;
+
+		m_sorted = m_samples;
+		size_t index = std::min(m_sorted.size() - 1, size_t(fraction * float(m_sorted.size())));
+		std::nth_element(m_sorted.begin(), m_sorted.begin() + index, m_sorted.end());
+		return m_sorted[index];
+	}
+
+	void InputLatency::clear()
+	{
+		m_samples.clear();
+		m_pending.clear();
+		m_next = 0;
+	}
+}
@@ -0,0 +1,49 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#ifndef TOY_INPUTLATENCY_H
+#define TOY_INPUTLATENCY_H
+
+/* toy */
+#include <toyobj/Util/NonCopy.h>
+#include <toyui/Types.h>
+
+/* std */
+#include <cstdint>
+#include <vector>
+
+namespace toy
+{
+	// Measures the time from an input event being queued to the first frame presenting its effects
+	// An event is traced when its dispatch marks any frame dirty : the tag then waits through relayout until the frame is presented
+	class TOY_UI_EXPORT InputLatency : public NonCopy
+	{
+	public:
+		InputLatency(size_t capacity = 1024);
+
+		void beginEvent(uint64_t time);
+		void endEvent();
+		void dirtied();
+		void presented();
+
+		// latency in milliseconds under which the given fraction of the recorded events fall
+		float percentile(float fraction);
+		size_t count() { return m_samples.size(); }
+		void clear();
+
+		static InputLatency* s_active;
+
+	protected:
+		size_t m_capacity;
+		size_t m_next;
+		std::vector<float> m_samples;
+		std::vector<uint64_t> m_pending;
+		std::vector<float> m_sorted;
+
+		uint64_t m_current;
+		bool m_dirtied;
+	};
+}
+
+#endif // TOY_INPUTLATENCY_H
@@ -0,0 +1,147 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#include <toyui/Config.h>
+#include <toyui/Input/InputQueue.h>
+
+#include <toyui/Input/InputDevice.h>
+#include <toyui/Input/InputLatency.h>
+#include <toyui/Log.h>
+
+#include <chrono>
+
+namespace toy
+{
+	InputQueue::InputQueue()
+		: m_time(0)
+		, m_events()
+		, m_head(0)
+		, m_tail(0)
+		, m_dropped(0)
+	{}
+
+	uint64_t InputQueue::now()
+	{
+		using namespace std::chrono;
+		return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+	}
+
+	bool InputQueue::push(const RawInputEvent& event)
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+		if(tail - m_head.load(std::memory_order_acquire) == s_capacity)
+		{
+			m_dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		m_events[tail % s_capacity] = event;
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool InputQueue::pop(RawInputEvent& event)
+	{
+		size_t head = m_head.load(std::memory_order_relaxed);
+		if(head == m_tail.load(std::memory_order_acquire))
+			return false;
+
+		event = m_events[head % s_capacity];
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	void InputQueue::pushMouseMoved(DimFloat pos)
+	{
+		this->push({ RAW_MOUSE_MOVED, now(), pos, 0.f, NO_BUTTON, KC_UNASSIGNED, 0 });
+	}
+
+	void InputQueue::pushMousePressed(DimFloat pos, MouseButtonCode button)
+	{
+		this->push({ RAW_MOUSE_PRESSED, now(), pos, 0.f, button, KC_UNASSIGNED, 0 });
+	}
+
+	void InputQueue::pushMouseReleased(DimFloat pos, MouseButtonCode button)
+	{
+		this->push({ RAW_MOUSE_RELEASED, now(), pos, 0.f, button, KC_UNASSIGNED, 0 });
+	}
+
+	void InputQueue::pushMouseWheeled(DimFloat pos, float amount)
+	{
+		this->push({ RAW_MOUSE_WHEELED, now(), pos, amount, NO_BUTTON, KC_UNASSIGNED, 0 });
+	}
+
+	void InputQueue::pushKeyPressed(KeyCode key, char c)
+	{
+		this->push({ RAW_KEY_PRESSED, now(), { 0.f, 0.f }, 0.f, NO_BUTTON, key, c });
+	}
+
+	void InputQueue::pushKeyReleased(KeyCode key, char c)
+	{
+		this->push({ RAW_KEY_RELEASED, now(), { 0.f, 0.f }, 0.f, NO_BUTTON, key, c });
+	}
+
+	static void flush_mouse_moved(Mouse& mouse, uint64_t time, InputLatency* latency)
+	{
+		if(!mouse.m_movePending)
+			return;
+
+		if(latency)
+			latency->beginEvent(time);
+
+		mouse.flushMouseMoved();
+
+		if(latency)
+			latency->endEvent();
+	}
+
+	void InputQueue::drain(Mouse& mouse, Keyboard& keyboard, InputLatency* latency)
+	{
+		// only the events already queued when draining starts are dispatched : later ones wait for the next frame
+		size_t count = m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_relaxed);
+
+		size_t dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+		if(dropped)
+			Log::print(LOG_WARNING, "Input queue full, dropped %i events\n", int(dropped));
+
+		uint64_t moveTime = 0;
+
+		RawInputEvent event;
+		for(size_t i = 0; i < count && this->pop(event); ++i)
+		{
+			m_time = event.m_time;
+
+			if(event.m_type == RAW_MOUSE_MOVED)
+			{
+				// the coalesced move is traced from its earliest sample, the one that waited the longest
+				if(!mouse.m_movePending)
+					moveTime = event.m_time;
+				mouse.queueMouseMoved(event.m_pos);
+				continue;
+			}
+
+			// a move pending before a press or a key is dispatched first, traced from its own samples rather than from the event
+			flush_mouse_moved(mouse, moveTime, latency);
+
+			if(latency)
+				latency->beginEvent(event.m_time);
+
+			if(event.m_type == RAW_MOUSE_PRESSED)
+				mouse.dispatchMousePressed(event.m_pos, event.m_button);
+			else if(event.m_type == RAW_MOUSE_RELEASED)
+				mouse.dispatchMouseReleased(event.m_pos, event.m_button);
+			else if(event.m_type == RAW_MOUSE_WHEELED)
+				mouse.dispatchMouseWheeled(event.m_pos, event.m_amount);
+			else if(event.m_type == RAW_KEY_PRESSED)
+				keyboard.dispatchKeyPressed(event.m_key, event.m_char);
+			else if(event.m_type == RAW_KEY_RELEASED)
+				keyboard.dispatchKeyReleased(event.m_key, event.m_char);
+
+			if(latency)
+				latency->endEvent();
+		}
+
+		flush_mouse_moved(mouse, moveTime, latency);
+	}
+}
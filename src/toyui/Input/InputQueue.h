@@ -0,0 +1,79 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#ifndef TOY_INPUTQUEUE_H
+#define TOY_INPUTQUEUE_H
+
+/* toy */
+#include <toyobj/Util/NonCopy.h>
+#include <toyui/Types.h>
+#include <toyui/Input/KeyCode.h>
+#include <toyui/Frame/Dim.h>
+
+/* std */
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace toy
+{
+	enum RawInputType : unsigned int
+	{
+		RAW_MOUSE_MOVED,
+		RAW_MOUSE_PRESSED,
+		RAW_MOUSE_RELEASED,
+		RAW_MOUSE_WHEELED,
+		RAW_KEY_PRESSED,
+		RAW_KEY_RELEASED
+	};
+
+	struct TOY_UI_EXPORT RawInputEvent
+	{
+		RawInputType m_type;
+		uint64_t m_time;
+		DimFloat m_pos;
+		float m_amount;
+		MouseButtonCode m_button;
+		KeyCode m_key;
+		char m_char;
+	};
+
+	// Single producer / single consumer ring of raw input : the platform layer pushes, possibly from its own thread, and UiWindow drains it once per frame
+	class TOY_UI_EXPORT InputQueue : public NonCopy
+	{
+	public:
+		InputQueue();
+
+		// microseconds on a monotonic clock
+		static uint64_t now();
+
+		bool push(const RawInputEvent& event);
+		bool pop(RawInputEvent& event);
+
+		void pushMouseMoved(DimFloat pos);
+		void pushMousePressed(DimFloat pos, MouseButtonCode button);
+		void pushMouseReleased(DimFloat pos, MouseButtonCode button);
+		void pushMouseWheeled(DimFloat pos, float amount);
+		void pushKeyPressed(KeyCode key, char c);
+		void pushKeyReleased(KeyCode key, char c);
+
+		void drain(Mouse& mouse, Keyboard& keyboard, InputLatency* latency = nullptr);
+
+	public:
+		static const size_t s_capacity = 4096;
+
+		uint64_t m_time;
+
+	protected:
+		std::array<RawInputEvent, s_capacity> m_events;
+
+		alignas(64) std::atomic<size_t> m_head;
+		alignas(64) std::atomic<size_t> m_tail;
+
+		// events dropped on a full queue since the last drain, reported once by the consumer
+		std::atomic<size_t> m_dropped;
+	};
+}
+
+#endif // TOY_INPUTQUEUE_H
@@ -0,0 +1,212 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#include <toyui/Config.h>
+#include <toyui/Input/InputRecord.h>
+
+#include <toyui/Render/RenderWindow.h>
+#include <toyui/Log.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace toy
+{
+	// file layout : a magic and a version, then records made of a frame number, a type, and a fixed size payload, all little endian
+	const char c_recordMagic[4] = { 'T', 'O', 'Y', 'I' };
+	const uint32_t c_recordVersion = 1;
+	const uint8_t c_recordResize = 0xFF;
+
+	inline bool bigEndian() { const uint16_t probe = 1; return *reinterpret_cast<const uint8_t*>(&probe) == 0; }
+
+	template <class T>
+	inline void writeValue(FILE* file, T value)
+	{
+		unsigned char bytes[sizeof(T)];
+		memcpy(bytes, &value, sizeof(T));
+		if(bigEndian())
+			std::reverse(bytes, bytes + sizeof(T));
+		fwrite(bytes, sizeof(T), 1, file);
+	}
+
+	template <class T>
+	inline bool readValue(FILE* file, T& value)
+	{
+		unsigned char bytes[sizeof(T)];
+		if(fread(bytes, sizeof(T), 1, file) != 1)
+			return false;
+		if(bigEndian())
+			std::reverse(bytes, bytes + sizeof(T));
+		memcpy(&value, bytes, sizeof(T));
+		return true;
+	}
+
+	RecordInputWindow::RecordInputWindow(object_ptr<InputWindow> input, const string& path)
+		: InputWindow()
+		, m_input(std::move(input))
+		, m_file(fopen(path.c_str(), "wb"))
+		, m_frame(0)
+	{
+		if(!m_file)
+		{
+			Log::print(LOG_ERROR, "Could not open input record file %s\n", path.c_str());
+			return;
+		}
+
+		fwrite(c_recordMagic, 1, 4, m_file);
+		writeValue(m_file, c_recordVersion);
+	}
+
+	RecordInputWindow::~RecordInputWindow()
+	{
+		if(m_file)
+			fclose(m_file);
+	}
+
+	void RecordInputWindow::initInput(RenderWindow& renderWindow, Mouse& mouse, Keyboard& keyboard)
+	{
+		m_input->initInput(renderWindow, mouse, keyboard);
+	}
+
+	void RecordInputWindow::resize(size_t width, size_t height)
+	{
+		m_input->resize(width, height);
+
+		if(!m_file) return;
+		writeValue(m_file, m_frame);
+		writeValue(m_file, c_recordResize);
+		writeValue(m_file, uint32_t(width));
+		writeValue(m_file, uint32_t(height));
+	}
+
+	bool RecordInputWindow::nextFrame()
+	{
+		bool pursue = m_input->nextFrame();
+		m_cursorX = m_input->m_cursorX;
+		m_cursorY = m_input->m_cursorY;
+
+		RawInputEvent event;
+		while(m_input->m_queue.pop(event))
+		{
+			if(m_file)
+			{
+				writeValue(m_file, m_frame);
+				writeValue(m_file, uint8_t(event.m_type));
+				writeValue(m_file, event.m_time);
+				writeValue(m_file, event.m_pos.x);
+				writeValue(m_file, event.m_pos.y);
+				writeValue(m_file, event.m_amount);
+				writeValue(m_file, uint8_t(event.m_button));
+				writeValue(m_file, uint16_t(event.m_key));
+				writeValue(m_file, event.m_char);
+			}
+
+			m_queue.push(event);
+		}
+
+		++m_frame;
+		return pursue;
+	}
+
+	ReplayInputWindow::ReplayInputWindow(const string& path)
+		: InputWindow()
+		, m_renderWindow(nullptr)
+		, m_file(fopen(path.c_str(), "rb"))
+		, m_frame(0)
+		, m_pending(false)
+		, m_recordFrame(0)
+		, m_recordType(0)
+		, m_event()
+		, m_width(0)
+		, m_height(0)
+		, m_start(0)
+		, m_done(false)
+	{
+		m_cursorX = 0.f;
+		m_cursorY = 0.f;
+
+		char magic[4];
+		uint32_t version = 0;
+		if(!m_file)
+			Log::print(LOG_ERROR, "Could not open input record file %s\n", path.c_str());
+		else if(fread(magic, 1, 4, m_file) != 4 || memcmp(magic, c_recordMagic, 4) != 0 || !readValue(m_file, version) || version != c_recordVersion)
+			Log::print(LOG_ERROR, "%s is not an input record file\n", path.c_str());
+		else
+			m_pending = this->readRecord();
+	}
+
+	ReplayInputWindow::~ReplayInputWindow()
+	{
+		if(m_file)
+			fclose(m_file);
+	}
+
+	void ReplayInputWindow::initInput(RenderWindow& renderWindow, Mouse& mouse, Keyboard& keyboard)
+	{
+		UNUSED(mouse); UNUSED(keyboard);
+		m_renderWindow = &renderWindow;
+		m_start = InputQueue::now();
+	}
+
+	void ReplayInputWindow::resize(size_t width, size_t height)
+	{
+		UNUSED(width); UNUSED(height);
+	}
+
+	bool ReplayInputWindow::readRecord()
+	{
+		if(!readValue(m_file, m_recordFrame) || !readValue(m_file, m_recordType))
+			return false;
+
+		if(m_recordType == c_recordResize)
+			return readValue(m_file, m_width) && readValue(m_file, m_height);
+
+		uint8_t button;
+		uint16_t key;
+		m_event.m_type = RawInputType(m_recordType);
+		bool read = readValue(m_file, m_event.m_time) && readValue(m_file, m_event.m_pos.x) && readValue(m_file, m_event.m_pos.y)
+				 && readValue(m_file, m_event.m_amount) && readValue(m_file, button) && readValue(m_file, key) && readValue(m_file, m_event.m_char);
+		m_event.m_button = MouseButtonCode(button);
+		m_event.m_key = KeyCode(key);
+		return read;
+	}
+
+	bool ReplayInputWindow::nextFrame()
+	{
+		while(m_pending && m_recordFrame == m_frame)
+		{
+			if(m_recordType == c_recordResize)
+			{
+				// picked up by UiWindow at the start of the next frame
+				m_renderWindow->m_width = m_width;
+				m_renderWindow->m_height = m_height;
+			}
+			else
+			{
+				if(m_event.m_type <= RAW_MOUSE_WHEELED)
+				{
+					m_cursorX = m_event.m_pos.x;
+					m_cursorY = m_event.m_pos.y;
+				}
+				// the recorded time comes from the clock of the recording process : latency is measured from the replayed push
+				m_event.m_time = InputQueue::now();
+				m_queue.push(m_event);
+			}
+
+			m_pending = this->readRecord();
+		}
+
+		++m_frame;
+
+		if(m_pending)
+			return true;
+		if(m_done)
+			return false;
+
+		m_done = true;
+		float elapsed = float(InputQueue::now() - m_start) / 1000.f;
+		Log::print(LOG_INFO, "Replayed %u frames in %.2f ms, %.3f ms per frame\n", m_frame, elapsed, elapsed / float(m_frame));
+		return false;
+	}
+}
@@ -0,0 +1,67 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#ifndef TOY_INPUTRECORD_H
+#define TOY_INPUTRECORD_H
+
+/* toy */
+#include <toyui/Types.h>
+#include <toyui/Input/InputDispatcher.h>
+
+/* std */
+#include <cstdio>
+
+namespace toy
+{
+	// Wraps the input window of a context and records every event it queues, along with resizes, tagged by frame number
+	class TOY_UI_EXPORT RecordInputWindow : public InputWindow
+	{
+	public:
+		RecordInputWindow(object_ptr<InputWindow> input, const string& path);
+		~RecordInputWindow();
+
+		virtual bool nextFrame();
+
+		virtual void initInput(RenderWindow& renderWindow, Mouse& mouse, Keyboard& keyboard);
+		virtual void resize(size_t width, size_t height);
+
+	protected:
+		object_ptr<InputWindow> m_input;
+		FILE* m_file;
+		uint32_t m_frame;
+	};
+
+	// Feeds a recorded session back frame by frame, as fast as the frames are run : nextFrame returns false once the recording is exhausted
+	class TOY_UI_EXPORT ReplayInputWindow : public InputWindow
+	{
+	public:
+		ReplayInputWindow(const string& path);
+		~ReplayInputWindow();
+
+		virtual bool nextFrame();
+
+		virtual void initInput(RenderWindow& renderWindow, Mouse& mouse, Keyboard& keyboard);
+		virtual void resize(size_t width, size_t height);
+
+	protected:
+		bool readRecord();
+
+	protected:
+		RenderWindow* m_renderWindow;
+		FILE* m_file;
+		uint32_t m_frame;
+
+		bool m_pending;
+		uint32_t m_recordFrame;
+		uint8_t m_recordType;
+		RawInputEvent m_event;
+		uint32_t m_width;
+		uint32_t m_height;
+
+		uint64_t m_start;
+		bool m_done;
+	};
+}
+
+#endif // TOY_INPUTRECORD_H
@@ -0,0 +1,29 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#include <toyui/Config.h>
+#include <toyui/Log.h>
+
+/* std */
+#include <cstdarg>
+#include <cstdio>
+
+namespace toy
+{
+	LogLevel Log::s_level = LOG_INFO;
+
+	void Log::print(LogLevel level, const char* format, ...)
+	{
+		if(level > s_level)
+			return;
+
+		static const char* prefixes[] = { "ERROR: ", "WARNING: ", "INFO: ", "DEBUG: " };
+		fputs(prefixes[level], stdout);
+
+		va_list args;
+		va_start(args, format);
+		vprintf(format, args);
+		va_end(args);
+	}
+}
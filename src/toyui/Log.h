@@ -0,0 +1,31 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#ifndef TOY_LOG_H
+#define TOY_LOG_H
+
+/* toy */
+#include <toyui/Types.h>
+
+namespace toy
+{
+	enum LogLevel : unsigned int
+	{
+		LOG_ERROR,
+		LOG_WARNING,
+		LOG_INFO,
+		LOG_DEBUG
+	};
+
+	// printf style logging, prefixed with the level : messages above the current level are dropped before formatting
+	class TOY_UI_EXPORT Log
+	{
+	public:
+		static void print(LogLevel level, const char* format, ...);
+
+		static LogLevel s_level;
+	};
+}
+
+#endif // TOY_LOG_H
@@ -6,9 +6,13 @@
 #include <toyui/Render/Renderer.h>
 
 #include <toyui/Frame/Layer.h>
+#include <toyui/Frame/Highlighter.h>
 
 #include <toyui/Widget/Widget.h>
 #include <toyui/Widget/Sheet.h>
+#include <toyui/Widget/RootSheet.h>
+
+#include <algorithm>
 
 namespace toy
 {
@@ -28,9 +32,8 @@ namespace toy
 		, m_null(false)
 		, m_debugBatch(0)
 		, m_debugDepth(0)
-		, m_debugPrintFilter("")
 		, m_debugPrint(true)
-		, m_debugDrawFilter("")
+		, m_debugDrawFilter(0)
 		, m_debugDrawFrameRect(false)
 		, m_debugDrawPaddedRect(false)
 		, m_debugDrawContentRect(false)
@@ -53,7 +56,7 @@ namespace toy
 
 #ifdef TOYUI_DRAW_CACHE
 		target.m_layer.visit([this](Layer& layer) {
-			if(layer.visible())
+			if(layer.visible() && !layer.d_overlay)
 			{
 				void* layerCache = nullptr;
 				this->layerCache(layer, layerCache);
@@ -62,6 +65,10 @@ namespace toy
 		});
 #endif
 
+		// overlays are drawn last, on top of every layer
+		if(is<RootSheet>(*target.m_layer.d_wedge))
+			this->renderOverlays(as<RootSheet>(*target.m_layer.d_wedge), target.m_layer);
+
 		if(m_debugBatch > 1 /*&& m_debugBatch != prevBatch*/)
 		{
 			prevBatch = m_debugBatch;
@@ -71,6 +78,34 @@ namespace toy
 		this->endFrame();
 	}
 
+	void Renderer::renderOverlays(RootSheet& rootSheet, Layer& layer)
+	{
+		Cursor& cursor = rootSheet.m_cursor;
+		if(!cursor.m_overlay)
+			return;
+
+		// drawn from their current position every frame, on top of everything else
+		if(!cursor.tooltip().frame().d_hidden)
+			this->renderOverlay(cursor.tooltip(), layer);
+		if(!cursor.frame().d_hidden)
+			this->renderOverlay(cursor, layer);
+	}
+
+	void Renderer::renderOverlay(Widget& widget, Layer& layer)
+	{
+#ifdef TOYUI_DRAW_CACHE
+		// the overlay is recorded again in its own layer cache, which is composited after all the other layers
+		UNUSED(layer);
+		Layer& overlay = as<Layer>(widget.frame());
+		void* layerCache = nullptr;
+		this->layerCache(overlay, layerCache);
+		this->render(widget, overlay, true);
+		this->drawLayer(layerCache, 0.f, 0.f, 1.f);
+#else
+		this->render(widget, layer, true);
+#endif
+	}
+
 	void Renderer::render(Widget& widget, Layer& layer, bool force)
 	{
 		this->beginDraw(layer, widget.frame(), force);
@@ -89,7 +124,7 @@ namespace toy
 		this->draw(layer, wedge.frame(), force);
 
 		for(size_t i = 0; i < wedge.m_contents.size(); ++i)
-			if(!wedge.m_contents[i]->frame().d_hidden)
+			if(!wedge.m_contents[i]->frame().d_hidden && !wedge.m_contents[i]->frame().d_overlay)
 			{
 				if(is<Wedge>(*wedge.m_contents[i]))
 					this->render(as<Wedge>(*wedge.m_contents[i]), layer, force);
@@ -169,7 +204,7 @@ namespace toy
 		BoxFloat contentRect(contentPos.x, contentPos.y, contentSize.x, contentSize.y);
 		
 #if 1 // DEBUG
-		if(frame.d_style->m_name == m_debugDrawFilter)
+		if(m_debugDrawFilter && frame.d_style->m_id == m_debugDrawFilter)
 			this->debugRect(rect, Colour::Red);
 		if(m_debugDrawFrameRect)
 			this->debugRect(rect, Colour::Red);
@@ -299,16 +334,65 @@ namespace toy
 			this->drawImage(*frame.d_icon->m_image, contentRect);
 
 		if(frame.d_caption)
-			for(TextRow& row : frame.d_caption->m_textRows)
+		{
+			std::vector<TextRow>& rows = frame.d_caption->m_textRows;
+
+			size_t first = 0;
+			size_t last = rows.size();
+
+			BoxFloat clip;
+			if(rows.size() > 1 && this->clipBounds(clip))
+				frame.d_caption->visibleRows(clip.y - paddedRect.y, clip.y + clip.h - paddedRect.y, first, last);
+
+			for(size_t i = first; i < last; ++i)
 			{
+				TextRow& row = rows[i];
+
 				if(!row.selected.null())
 					this->drawRect(BoxFloat(paddedRect.x + row.selected.x, paddedRect.y + row.selected.y, row.selected.w, row.selected.h), BoxFloat(), textSelectionStyle);
 
-				this->drawText(paddedRect.x + row.rect.x, paddedRect.y + row.rect.y, row.start, row.end, *frame.d_inkstyle);
+				// highlighted runs are laid one after the other from the left, aligned captions fall back to plain text
+				if(frame.d_caption->m_highlighter && frame.d_inkstyle->m_align.x == LEFT)
+					this->drawTextRuns(paddedRect.x + row.rect.x, paddedRect.y + row.rect.y, row, *frame.d_caption->m_highlighter, *frame.d_inkstyle);
+				else
+					this->drawText(paddedRect.x + row.rect.x, paddedRect.y + row.rect.y, row.start, row.end, *frame.d_inkstyle);
 
 				if(!row.caret.null())
 					this->drawRect(BoxFloat(paddedRect.x + row.caret.x, paddedRect.y + row.caret.y, row.caret.w, row.caret.h), BoxFloat(), caretStyle);
 			}
+		}
+	}
+
+	void Renderer::drawTextRuns(float x, float y, const TextRow& row, Highlighter& highlighter, InkStyle& skin)
+	{
+		// runs are drawn one after the other from the pen position returned by each : only left aligned captions are drawn this way
+		const char* text = row.start - row.startIndex;
+		size_t position = row.startIndex;
+
+		for(size_t i = highlighter.lineIndex(position); i < highlighter.m_lines.size() && position < row.endIndex; ++i)
+		{
+			HighlightLine& line = highlighter.m_lines[i];
+			size_t lineStart = highlighter.lineStart(i);
+			if(lineStart >= row.endIndex)
+				break;
+			for(const TextSpan& span : line.m_spans)
+			{
+				size_t start = std::max(lineStart + span.start, position);
+				size_t end = std::min(lineStart + span.end, row.endIndex);
+				if(lineStart + span.start >= row.endIndex)
+					break;
+				if(start >= end)
+					continue;
+
+				if(position < start)
+					x = this->drawText(x, y, text + position, text + start, skin);
+				x = this->drawText(x, y, text + start, text + end, span.style ? *span.style : skin);
+				position = end;
+			}
+		}
+
+		if(position < row.endIndex)
+			this->drawText(x, y, text + position, text + row.endIndex, skin);
 	}
 
 	void Renderer::logFPS()
@@ -33,11 +33,14 @@ namespace toy
 		// drawing implementation
 		void render(Wedge& wedge, Layer& layer, bool force);
 		void render(Widget& widget, Layer& layer, bool force);
+		void renderOverlays(RootSheet& rootSheet, Layer& layer);
+		void renderOverlay(Widget& widget, Layer& layer);
 		void beginDraw(Layer& layer, Frame& frame, bool force);
 		void draw(Layer& layer, Frame& frame, bool force);
 		BoxFloat selectCorners(Frame& frame);
 		void contentPos(Frame& frame, const BoxFloat& paddedRect, const DimFloat& size, Dimension dim, DimFloat& pos);
 		void drawContent(Frame& frame, const BoxFloat& rect, const BoxFloat& paddedRect, const BoxFloat& contentRect);
+		void drawTextRuns(float x, float y, const TextRow& row, Highlighter& highlighter, InkStyle& skin);
 		void drawBackground(Frame& frame, const BoxFloat& rect, const BoxFloat& paddedRect, const BoxFloat& contentRect);
 		void drawSkinImage(Frame& frame, int section, BoxFloat rect);
 		void endDraw(Layer& layer, Frame& frame);
@@ -81,6 +84,7 @@ namespace toy
 #endif
 
 		virtual bool clipTest(const BoxFloat& rect) = 0;
+		virtual bool clipBounds(BoxFloat& bounds) = 0;
 		virtual void clipRect(const BoxFloat& rect) = 0;
 		virtual void unclipRect() = 0;
 
@@ -96,7 +100,7 @@ namespace toy
 
 		virtual void drawShadow(const BoxFloat& rect, const BoxFloat& corner, const Shadow& shadows) = 0;
 		virtual void drawRect(const BoxFloat& rect, const BoxFloat& corners, InkStyle& skin) = 0;
-		virtual void drawText(float x, float y, const char* start, const char* end, InkStyle& skin) = 0;
+		virtual float drawText(float x, float y, const char* start, const char* end, InkStyle& skin) = 0;
 
 		virtual void drawImage(const Image& image, const BoxFloat& rect) = 0;
 		virtual void drawImageStretch(const Image& image, const BoxFloat& rect, float xstretch = 1.f, float ystretch = 1.f) = 0;
@@ -119,9 +123,8 @@ namespace toy
 		bool m_null;
 
 	public:
-		string m_debugPrintFilter;
 		bool m_debugPrint;
-		string m_debugDrawFilter;
+		StyleId m_debugDrawFilter;
 		bool m_debugDrawFrameRect;
 		bool m_debugDrawPaddedRect;
 		bool m_debugDrawContentRect;
@@ -15,6 +15,10 @@
 
 #include <toyui/Edit/Input.h>
 
+#include <toyui/Log.h>
+
+#include <algorithm>
+
 namespace toy
 {
 	static void init_options(Ref object, Options& options)
@@ -24,70 +28,126 @@ namespace toy
 				object.meta().m_members[i].set(object, options.m_fields[i]);
 	}
 
+	static void init_options(Ref object, Options* options)
+	{
+		if(!options) return;
+		init_options(object, *options);
+	}
+
+	const size_t Style::s_states;
+	size_t Style::s_generation = 1;
+
+	StyleIndex* StyleIndex::s_active = nullptr;
+
 	Style::Style(const string& name, Type* type, Style* base, Args args)
 		: m_style_type(type)
 		, m_base(base)
 		, m_name(name)
 		, m_args(args)
+		, m_generation(0)
 	{
-		Widget::s_styles[name] = this;
+		m_id = StyleRegistry::add(*this);
 		this->init();
 	}
 
 	void Style::init()
 	{
+		if(m_generation == s_generation) return;
+		m_generation = s_generation;
+
 		m_defined = false;
 		m_layout = { m_name };
 		m_skin = { m_name };
 		m_skins = {};
+		m_skinTable.clear();
 
 		if(m_base)
 		{
 			m_base->init();
-			m_layout = m_base->m_layout;
+			m_layout = m_base->m_initLayout;
 			m_layout.m_name = m_name;
 		}
 
 		set_members(&m_layout, m_args);
 		set_members(&m_skin, m_args);
+
+		m_initLayout = m_layout;
 	}
 
-	void Style::load(StyleMap& layout_defs, StyleMap& skin_defs)
+	StyleIndex::StyleIndex(StyleMap& layout_defs, StyleMap& skin_defs)
+		: m_layout_defs(layout_defs)
+		, m_skin_defs(skin_defs)
+	{
+		for(auto& kv : skin_defs)
+		{
+			size_t separator = kv.first.find(':');
+			if(separator == string::npos)
+				continue;
+
+			WidgetStates states = from_string<WidgetStates>(splitString(kv.first, ":")[1]);
+			m_declined[kv.first.substr(0, separator)].push_back({ states, &kv.second });
+		}
+	}
+
+	void Style::load(StyleIndex& index)
 	{
 		if(m_defined) return;
 
 		if(m_base)
-			m_base->load(layout_defs, skin_defs);
+			m_base->load(index);
 
-		printf("INFO: Loading style %s\n", m_name.c_str());
-		this->define(*this, layout_defs, skin_defs);
+		Log::print(LOG_DEBUG, "Loading style %s\n", m_name.c_str());
+		m_initSkin = m_skin;
+		this->define(*this, index);
 
 		m_skin.prepare();
 		for(InkStyle& skin : m_skins)
 			skin.prepare();
 
+		this->updateSkinTable();
+
 		m_defined = true;
 	}
 
-	void Style::define(Style& style, StyleMap& layout_defs, StyleMap& skin_defs)
+	void Style::redefine()
 	{
-		//if(style.m_base)
-		//	this->load(*style.m_base, layout_defs, skin_defs);
-		
-		init_options(&m_layout, layout_defs[style.m_name]);
-		init_options(&m_skin, skin_defs[style.m_name]);
+		if(!m_defined) return;
 
-		for(auto& kv : skin_defs)
-			if(kv.first.find(style.m_name + ":") == 0)
-			{
-				WidgetStates states = from_string<WidgetStates>(splitString(kv.first, ":")[1]);
-				InkStyle& skin = decline_skin(states);
-				init_options(&skin, skin_defs[style.m_name]);
-				init_options(&skin, skin_defs[kv.first]);
-			}
+		m_defined = false;
+		m_layout = m_initLayout;
+		m_skin = m_initSkin;
+		m_skins = {};
+		m_skinTable.clear();
 	}
 
-	InkStyle& Style::skin(WidgetState state)
+	void Style::resolve()
+	{
+		if(!m_defined && StyleIndex::s_active)
+			this->load(*StyleIndex::s_active);
+		if(m_skinTable.empty())
+			this->updateSkinTable();
+	}
+
+	void Style::define(Style& style, StyleIndex& index)
+	{
+		Options* skin_def = index.skin(style.m_name);
+
+		init_options(&m_layout, index.layout(style.m_name));
+		init_options(&m_skin, skin_def);
+
+		std::vector<StyleIndex::Declined>* declined = index.declined(style.m_name);
+		if(!declined)
+			return;
+
+		for(StyleIndex::Declined& definition : *declined)
+		{
+			InkStyle& skin = decline_skin(definition.m_states);
+			init_options(&skin, skin_def);
+			init_options(&skin, *definition.m_definition);
+		}
+	}
+
+	InkStyle& Style::resolve_skin(WidgetState state)
 	{
 		// these two flags mess up the search and we never skin them anyway
 		state = static_cast<WidgetState>(state & ~(MODAL | CONTROL));
@@ -100,15 +160,246 @@ namespace toy
 		return m_skin;
 	}
 
+	void Style::updateSkinTable()
+	{
+		// most states resolve to the same few skins : each of them is interned once
+		std::vector<std::pair<InkStyle*, InkStyle*>> interned;
+
+		m_skinTable.resize(s_states);
+		for(size_t state = 0; state < s_states; ++state)
+		{
+			InkStyle* resolved = &this->resolve_skin(static_cast<WidgetState>(state));
+			auto it = std::find_if(interned.begin(), interned.end(), [resolved](const std::pair<InkStyle*, InkStyle*>& pair) { return pair.first == resolved; });
+			if(it == interned.end())
+				it = interned.insert(interned.end(), { resolved, &InkStylePool::intern(*resolved) });
+			m_skinTable[state] = (*it).second;
+		}
+	}
+
 	InkStyle& Style::decline_skin(WidgetStates state)
 	{
 		for(InkStyle& skin : m_skins)
 			if(state.value == skin.m_state)
 				return skin;
 
+		m_skinTable.clear();
 		m_skins.emplace_back(m_skin);
 		m_skins.back().m_name = m_name + ":" + toLower(to_string(state));
 		m_skins.back().m_state = static_cast<WidgetState>(state.value);
 		return m_skins.back();
 	}
+
+	std::unordered_map<size_t, std::vector<std::unique_ptr<InkStyle>>> InkStylePool::s_skins;
+	size_t InkStylePool::s_count = 0;
+
+	static inline void hash_combine(size_t& seed, size_t value)
+	{
+		seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	}
+
+	static inline void hash_colour(size_t& seed, const Colour& colour)
+	{
+		std::hash<float> hasher;
+		hash_combine(seed, hasher(colour.m_r)); hash_combine(seed, hasher(colour.m_g)); hash_combine(seed, hasher(colour.m_b)); hash_combine(seed, hasher(colour.m_a));
+	}
+
+	static inline void hash_box(size_t& seed, const BoxFloat& box)
+	{
+		std::hash<float> hasher;
+		for(size_t i = 0; i < 4; ++i)
+			hash_combine(seed, hasher(box[i]));
+	}
+
+	static inline bool same_colour(const Colour& first, const Colour& second)
+	{
+		return first.m_r == second.m_r && first.m_g == second.m_g && first.m_b == second.m_b && first.m_a == second.m_a;
+	}
+
+	static inline bool same_box(const BoxFloat& first, const BoxFloat& second)
+	{
+		return first[0] == second[0] && first[1] == second[1] && first[2] == second[2] && first[3] == second[3];
+	}
+
+	typedef bool (*CustomRendererFunc)(const Frame&, Renderer&);
+
+	size_t InkStylePool::hash(const InkStyle& skin)
+	{
+		std::hash<float> hasher;
+		size_t seed = std::hash<string>()(skin.m_text_font);
+		hash_colour(seed, skin.m_background_colour);
+		hash_colour(seed, skin.m_border_colour);
+		hash_colour(seed, skin.m_image_colour);
+		hash_colour(seed, skin.m_text_colour);
+		hash_combine(seed, hasher(skin.m_text_size));
+		hash_box(seed, skin.m_border_width);
+		hash_box(seed, skin.m_corner_radius);
+		hash_box(seed, skin.m_padding);
+		hash_box(seed, skin.m_margin);
+		hash_combine(seed, std::hash<const void*>()(skin.m_image));
+		hash_combine(seed, std::hash<const void*>()(skin.m_image_skin.d_image));
+		hash_combine(seed, std::hash<const void*>()(skin.m_hover_cursor));
+		return seed;
+	}
+
+	bool InkStylePool::same(const InkStyle& first, const InkStyle& second)
+	{
+		const ImageSkin& firstSkin = first.m_image_skin;
+		const ImageSkin& secondSkin = second.m_image_skin;
+		bool sameImageSkin = firstSkin.d_image == secondSkin.d_image
+			&& (!firstSkin.d_image || (firstSkin.d_left == secondSkin.d_left && firstSkin.d_top == secondSkin.d_top && firstSkin.d_right == secondSkin.d_right
+									   && firstSkin.d_bottom == secondSkin.d_bottom && firstSkin.m_margin == secondSkin.m_margin && firstSkin.d_stretch == secondSkin.d_stretch));
+
+		const Shadow& firstShadow = first.m_shadow;
+		const Shadow& secondShadow = second.m_shadow;
+		bool sameShadow = firstShadow.d_null == secondShadow.d_null
+			&& (firstShadow.d_null || (firstShadow.d_xpos == secondShadow.d_xpos && firstShadow.d_ypos == secondShadow.d_ypos && firstShadow.d_blur == secondShadow.d_blur
+									   && firstShadow.d_spread == secondShadow.d_spread && same_colour(firstShadow.d_colour, secondShadow.d_colour)));
+
+		// custom renderers can only be told apart when they are plain functions
+		const CustomRendererFunc* firstRenderer = first.m_customRenderer.target<CustomRendererFunc>();
+		const CustomRendererFunc* secondRenderer = second.m_customRenderer.target<CustomRendererFunc>();
+		bool sameRenderer = (!first.m_customRenderer && !second.m_customRenderer) || (firstRenderer && secondRenderer && *firstRenderer == *secondRenderer);
+
+		return first.m_empty == second.m_empty
+			&& same_colour(first.m_background_colour, second.m_background_colour) && same_colour(first.m_border_colour, second.m_border_colour)
+			&& same_colour(first.m_image_colour, second.m_image_colour) && same_colour(first.m_text_colour, second.m_text_colour)
+			&& first.m_text_font == second.m_text_font && first.m_text_size == second.m_text_size
+			&& first.m_text_break == second.m_text_break && first.m_text_wrap == second.m_text_wrap
+			&& same_box(first.m_border_width, second.m_border_width) && same_box(first.m_corner_radius, second.m_corner_radius)
+			&& first.m_weak_corners == second.m_weak_corners
+			&& same_box(first.m_padding, second.m_padding) && same_box(first.m_margin, second.m_margin)
+			&& first.m_align[0] == second.m_align[0] && first.m_align[1] == second.m_align[1]
+			&& first.m_linear_gradient == second.m_linear_gradient && first.m_linear_gradient_dim == second.m_linear_gradient_dim
+			&& first.m_image == second.m_image && first.m_overlay == second.m_overlay && first.m_tile == second.m_tile
+			&& sameImageSkin && sameShadow && same_colour(first.m_shadow_colour, second.m_shadow_colour)
+			&& first.m_hover_cursor == second.m_hover_cursor && sameRenderer;
+	}
+
+	InkStyle& InkStylePool::intern(const InkStyle& skin)
+	{
+		std::vector<std::unique_ptr<InkStyle>>& bucket = s_skins[hash(skin)];
+		for(std::unique_ptr<InkStyle>& interned : bucket)
+			if(same(*interned, skin))
+				return *interned;
+
+		bucket.emplace_back(make_unique<InkStyle>(skin));
+		++s_count;
+		return *bucket.back();
+	}
+
+	size_t InkStylePool::sweep(const std::unordered_set<const InkStyle*>& live)
+	{
+		size_t released = 0;
+		for(auto it = s_skins.begin(); it != s_skins.end();)
+		{
+			std::vector<std::unique_ptr<InkStyle>>& bucket = (*it).second;
+			auto dead = std::remove_if(bucket.begin(), bucket.end(), [&](const std::unique_ptr<InkStyle>& skin) { return live.find(skin.get()) == live.end(); });
+			released += bucket.end() - dead;
+			bucket.erase(dead, bucket.end());
+
+			if(bucket.empty())
+				it = s_skins.erase(it);
+			else
+				++it;
+		}
+
+		s_count -= released;
+		return released;
+	}
+
+	StyleId StyleRegistry::add(Style& style)
+	{
+		Index& registry = index();
+		registry.m_types.clear();
+
+		auto it = registry.m_ids.find(style.m_name);
+		if(it != registry.m_ids.end())
+		{
+			registry.m_styles[(*it).second - 1] = &style;
+			return (*it).second;
+		}
+
+		registry.m_styles.push_back(&style);
+		registry.m_ids[style.m_name] = registry.m_styles.size();
+		return registry.m_styles.size();
+	}
+
+	void StyleRegistry::declare(const std::vector<Type*>& types, const std::function<void()>& declarer)
+	{
+		Declarer shared = std::make_shared<std::function<void()>>(declarer);
+		for(Type* type : types)
+		{
+			index().m_declarers[type] = shared;
+			index().m_namedDeclarers[type->m_name] = shared;
+		}
+	}
+
+	void StyleRegistry::declareAll()
+	{
+		std::unordered_map<Type*, Declarer> declarers;
+		std::swap(declarers, index().m_declarers);
+		index().m_namedDeclarers.clear();
+		for(auto& kv : declarers)
+			run(kv.second);
+	}
+
+	void StyleRegistry::run(Declarer declarer)
+	{
+		if(!*declarer)
+			return;
+
+		std::function<void()> declare = std::move(*declarer);
+		*declarer = nullptr;
+		declare();
+	}
+
+	StyleId StyleRegistry::id(const string& name)
+	{
+		auto it = index().m_ids.find(name);
+		return it != index().m_ids.end() ? (*it).second : 0;
+	}
+
+	Style* StyleRegistry::find(const string& name)
+	{
+		// only the module declaring a type of that name is declared, a style it doesn't declare stays unknown
+		StyleId style = id(name);
+		if(!style)
+		{
+			auto declarer = index().m_namedDeclarers.find(name);
+			if(declarer == index().m_namedDeclarers.end())
+				return nullptr;
+
+			Declarer declare = (*declarer).second;
+			index().m_namedDeclarers.erase(declarer);
+			run(declare);
+			style = id(name);
+		}
+		return find(style);
+	}
+
+	Style* StyleRegistry::typeStyle(Type& type)
+	{
+		Index& registry = index();
+		auto it = registry.m_types.find(&type);
+		if(it != registry.m_types.end())
+			return (*it).second;
+
+		Style* style = nullptr;
+		for(Type* base = &type; base && !style; base = base->m_base)
+		{
+			auto declarer = registry.m_declarers.find(base);
+			if(declarer != registry.m_declarers.end())
+			{
+				Declarer declare = (*declarer).second;
+				registry.m_declarers.erase(declarer);
+				run(declare);
+			}
+			style = find(id(base->m_name));
+		}
+		if(!style)
+			style = find(id("Widget"));
+
+		registry.m_types[&type] = style;
+		return style;
+	}
 }
@@ -17,6 +17,9 @@
 
 /* std */
 #include <vector>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace toy
 {
@@ -64,13 +67,23 @@ namespace toy
 	public:
 		std::vector<Var> m_fields;
 
-		void set(size_t index, Var value) { if(index >= m_fields.size()) m_fields.resize(index+1); m_fields[index] = value; }
+		// fields set from a named palette colour, which are patched in place when the palette changes
+		std::map<size_t, string> m_variables;
+
+		void set(size_t index, Var value) { if(index >= m_fields.size()) m_fields.resize(index+1); m_fields[index] = value; m_variables.erase(index); }
+		void bind(size_t index, const string& variable, Var value) { set(index, value); m_variables[index] = variable; }
 
 		void merge(const Options& other)
 		{
 			for(size_t i = 0; i < other.m_fields.size(); ++i)
 				if(!other.m_fields[i].none())
-					set(i, other.m_fields[i]);
+				{
+					auto it = other.m_variables.find(i);
+					if(it != other.m_variables.end())
+						bind(i, (*it).second, other.m_fields[i]);
+					else
+						set(i, other.m_fields[i]);
+				}
 		}
 	};
 
@@ -119,6 +132,14 @@ namespace toy
 				m_empty = false;
 		}
 
+		// switching from this skin to the other only changes how the frame is painted : its content size and placement stay the same
+		bool paintOnly(const InkStyle& other) const
+		{
+			return m_text_font == other.m_text_font && m_text_size == other.m_text_size && m_text_break == other.m_text_break && m_text_wrap == other.m_text_wrap
+				&& m_padding[0] == other.m_padding[0] && m_padding[1] == other.m_padding[1] && m_padding[2] == other.m_padding[2] && m_padding[3] == other.m_padding[3]
+				&& m_image == other.m_image;
+		}
+
 		_attr_ _mut_ string m_name;
 		_attr_ _mut_ bool m_empty;
 		_attr_ _mut_ Colour m_background_colour;
@@ -149,8 +170,98 @@ namespace toy
 		WidgetState m_state;
 	};
 
+	// Interns skins by value : every distinct skin is stored once and shared, so identical paint state compares by pointer
+	// Interned skins outlive the redefinition of their style, so that frames can still read them while reloading
+	// Once every frame points to the new skins, the styler sweeps the ones nothing refers to anymore
+	class TOY_UI_EXPORT InkStylePool
+	{
+	public:
+		static InkStyle& intern(const InkStyle& skin);
+		// releases every interned skin not in the live set, returns the number released
+		static size_t sweep(const std::unordered_set<const InkStyle*>& live);
+		static size_t size() { return s_count; }
+
+		static size_t hash(const InkStyle& skin);
+		static bool same(const InkStyle& first, const InkStyle& second);
+
+	protected:
+		static std::unordered_map<size_t, std::vector<std::unique_ptr<InkStyle>>> s_skins;
+		static size_t s_count;
+	};
+
+	// Every declared style, indexed by name and by a dense integer identifier interned once at declaration
+	// Names are only hashed when declaring or looking up a style by name : hot paths compare identifiers, and widgets resolve their style through a cache per type
+	class TOY_UI_EXPORT StyleRegistry
+	{
+	public:
+		static StyleId add(Style& style);
+
+		// defers the declaration of a module's styles until a widget of one of these types is styled, or a style named after one of them is looked up
+		static void declare(const std::vector<Type*>& types, const std::function<void()>& declarer);
+		static void declareAll();
+
+		// identifiers start at 1, 0 is returned for an unknown name
+		static StyleId id(const string& name);
+		static Style* find(const string& name);
+		static Style* find(StyleId id) { return id && id <= index().m_styles.size() ? index().m_styles[id - 1] : nullptr; }
+
+		// the style declared for the closest type in the type chain, or the Widget style
+		static Style* typeStyle(Type& type);
+
+		static const std::vector<Style*>& styles() { return index().m_styles; }
+
+	protected:
+		// a declarer is shared by all the types of its module, and emptied once it has run
+		using Declarer = std::shared_ptr<std::function<void()>>;
+
+		struct Index
+		{
+			std::unordered_map<string, StyleId> m_ids;
+			std::vector<Style*> m_styles;
+			std::unordered_map<Type*, Style*> m_types;
+			std::unordered_map<Type*, Declarer> m_declarers;
+			std::unordered_map<string, Declarer> m_namedDeclarers;
+		};
+
+		static void run(Declarer declarer);
+
+		static Index& index() { static Index index; return index; }
+	};
+
 	using StyleMap = std::map<string, Options>;
 
+	// the definitions of a style sheet, with the state qualified skins indexed by style name and their states parsed once
+	class TOY_UI_EXPORT StyleIndex
+	{
+	public:
+		struct Declined
+		{
+			WidgetStates m_states;
+			Options* m_definition;
+		};
+
+		StyleIndex(StyleMap& layout_defs, StyleMap& skin_defs);
+
+		Options* layout(const string& name) { auto it = m_layout_defs.find(name); return it != m_layout_defs.end() ? &(*it).second : nullptr; }
+		Options* skin(const string& name) { auto it = m_skin_defs.find(name); return it != m_skin_defs.end() ? &(*it).second : nullptr; }
+		std::vector<Declined>* declined(const string& name) { auto it = m_declined.find(name); return it != m_declined.end() ? &(*it).second : nullptr; }
+
+		StyleMap& m_layout_defs;
+		StyleMap& m_skin_defs;
+		std::map<string, std::vector<Declined>> m_declined;
+
+		// definitions of the current style sheet, which styles are loaded from the first time they are used
+		static StyleIndex* s_active;
+	};
+
+	enum StyleChange : unsigned int
+	{
+		STYLE_UNCHANGED = 0,
+		STYLE_SKIN = 1 << 0,		// skin definitions changed
+		STYLE_LAYOUT = 1 << 1,		// layout definitions changed
+		STYLE_STRUCTURE = 1 << 2	// the solver or the space changed : solvers must be rebuilt
+	};
+
 	class _refl_ TOY_UI_EXPORT Style : public Struct
 	{
 	public:
@@ -161,12 +272,25 @@ namespace toy
 		Style(Type& type, Style& base, Args args = {}) : Style(type.m_name, &type, &base, args) {}
 
 		void init();
-		void load(StyleMap& layout_defs, StyleMap& skin_defs);
-		void define(Style& level, StyleMap& layout_defs, StyleMap& skin_defs);
+		void load(StyleIndex& index);
+		void define(Style& level, StyleIndex& index);
 
-		InkStyle& skin(WidgetState state);
+		// loads the style from the active style sheet on first use, and builds its skin table
+		void resolve();
+		bool resolved() const { return (m_defined || !StyleIndex::s_active) && !m_skinTable.empty(); }
+
+		// invalidates every style, which are then initialized again once each, bases first
+		static void reset() { ++s_generation; }
+
+		// restores this style only to its state before the sheet was applied, it loads again from the active sheet on next use
+		void redefine();
+
+		InkStyle& skin(WidgetState state) { if(m_skinTable.empty()) this->resolve(); return *m_skinTable[state & (s_states - 1)]; }
 		InkStyle& decline_skin(WidgetStates state);
 
+		InkStyle& resolve_skin(WidgetState state);
+		void updateSkinTable();
+
 	public:
 		_attr_ Type* m_style_type;
 		_attr_ Style* m_base;
@@ -177,6 +301,18 @@ namespace toy
 
 		Args m_args;
 		bool m_defined;
+		StyleId m_id;
+
+		// the layout before any style sheet definition, which derived styles start from
+		Layout m_initLayout;
+		// the skin as declared and set up in code, captured when the sheet is first applied
+		InkStyle m_initSkin;
+		size_t m_generation;
+		static size_t s_generation;
+
+		// interned skin for every combination of the 9 state bits, rebuilt whenever the skins change
+		static const size_t s_states = 1 << 9;
+		std::vector<InkStyle*> m_skinTable;
 	};
 
 	struct TOY_UI_EXPORT Styles
@@ -0,0 +1,553 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#include <toyui/Config.h>
+#include <toyui/Style/StyleCompiler.h>
+
+#include <toyobj/Reflect/Meta.h>
+#include <toyui/Generated/Meta.h>
+
+#include <toyui/Style/Style.h>
+#include <toyui/Style/StyleParser.h>
+#include <toyui/Widget/Widget.h>
+#include <toyui/UiLayout.h>
+#include <toyui/UiWindow.h>
+
+/* std */
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <map>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace toy
+{
+	static const char c_styleBlobMagic[4] = { 'T', 'O', 'Y', 'S' };
+	static const uint32_t c_styleBlobVersion = 3;
+
+	enum StyleDefinitionKind : uint8_t
+	{
+		LAYOUT_DEFINITION,
+		SKIN_DEFINITION
+	};
+
+	enum StyleFieldCodec : uint8_t
+	{
+		FIELD_STRING,
+		FIELD_BOOL,
+		FIELD_INT,
+		FIELD_SIZE,
+		FIELD_FLOAT,
+		FIELD_SOLVER,
+		FIELD_FLOW,
+		FIELD_CLIPPING,
+		FIELD_OPACITY,
+		FIELD_DIMENSION,
+		FIELD_SPACE,
+		FIELD_AUTOLAYOUT,
+		FIELD_ALIGN,
+		FIELD_PIVOT,
+		FIELD_DIMFLOAT,
+		FIELD_BOXFLOAT,
+		FIELD_COLOUR,
+		FIELD_SHADOW,
+		FIELD_IMAGE,
+		FIELD_IMAGE_SKIN,
+		FIELD_STYLE
+	};
+
+	inline bool big_endian() { const uint16_t probe = 1; return *reinterpret_cast<const uint8_t*>(&probe) == 0; }
+
+	// scalars are written little endian : only fixed width types and enums with a fixed underlying type go through pod()
+	class BlobWriter
+	{
+	public:
+		template <class T>
+		void pod(const T& value)
+		{
+			static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "only scalars are written as is");
+			char bytes[sizeof(T)];
+			memcpy(bytes, &value, sizeof(T));
+			if(big_endian())
+				std::reverse(bytes, bytes + sizeof(T));
+			m_data.append(bytes, sizeof(T));
+		}
+
+		void str(const string& value) { this->pod(uint32_t(value.size())); m_data.append(value); }
+
+		void colour(const Colour& colour) { this->pod(colour.m_r); this->pod(colour.m_g); this->pod(colour.m_b); this->pod(colour.m_a); }
+
+		string m_data;
+	};
+
+	class BlobReader
+	{
+	public:
+		BlobReader(const char* data, size_t size) : m_cursor(data), m_end(data + size), m_error(false) {}
+
+		template <class T>
+		void pod(T& value)
+		{
+			static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "only scalars are read as is");
+			if(size_t(m_end - m_cursor) < sizeof(T)) { m_error = true; return; }
+			char bytes[sizeof(T)];
+			memcpy(bytes, m_cursor, sizeof(T));
+			if(big_endian())
+				std::reverse(bytes, bytes + sizeof(T));
+			memcpy(&value, bytes, sizeof(T));
+			m_cursor += sizeof(T);
+		}
+
+		template <class T>
+		T pod() { T value = T(); this->pod(value); return value; }
+
+		string str()
+		{
+			uint32_t size = this->pod<uint32_t>();
+			if(size_t(m_end - m_cursor) < size) { m_error = true; return ""; }
+			string value(m_cursor, size);
+			m_cursor += size;
+			return value;
+		}
+
+		Colour colour() { float r = this->pod<float>(); float g = this->pod<float>(); float b = this->pod<float>(); float a = this->pod<float>(); return Colour(r, g, b, a); }
+
+		const char* m_cursor;
+		const char* m_end;
+		bool m_error;
+	};
+
+	// compound values are written member by member, int always as 32 bits and size_t as 64 bits
+	template <class T>
+	void write_value(BlobWriter& writer, const T& value) { writer.pod(value); }
+	inline void write_value(BlobWriter& writer, const int& value) { writer.pod(int32_t(value)); }
+	inline void write_value(BlobWriter& writer, const size_t& value) { writer.pod(uint64_t(value)); }
+	inline void write_value(BlobWriter& writer, const DimFloat& value) { writer.pod(value.x); writer.pod(value.y); }
+	inline void write_value(BlobWriter& writer, const Space& value) { writer.pod(value.direction); writer.pod(value.sizingLength); writer.pod(value.sizingDepth); }
+	template <class T>
+	void write_value(BlobWriter& writer, const Dim<T>& value) { writer.pod(value[0]); writer.pod(value[1]); }
+
+	template <class T>
+	void read_value(BlobReader& reader, T& value) { reader.pod(value); }
+	inline void read_value(BlobReader& reader, int& value) { value = int(reader.pod<int32_t>()); }
+	inline void read_value(BlobReader& reader, size_t& value) { value = size_t(reader.pod<uint64_t>()); }
+	inline void read_value(BlobReader& reader, DimFloat& value) { reader.pod(value.x); reader.pod(value.y); }
+	inline void read_value(BlobReader& reader, Space& value) { reader.pod(value.direction); reader.pod(value.sizingLength); reader.pod(value.sizingDepth); }
+	template <class T>
+	void read_value(BlobReader& reader, Dim<T>& value) { reader.pod(value[0]); reader.pod(value[1]); }
+
+	class MappedFile : public NonCopy
+	{
+	public:
+		MappedFile(const string& path)
+			: m_data(nullptr)
+			, m_size(0)
+		{
+#ifdef _WIN32
+			std::ifstream file(path, std::ios::binary);
+			if(!file) return;
+			m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+			m_data = m_buffer.data();
+			m_size = m_buffer.size();
+#else
+			int fd = open(path.c_str(), O_RDONLY);
+			if(fd < 0) return;
+
+			struct stat info;
+			if(fstat(fd, &info) == 0 && info.st_size > 0)
+			{
+				void* data = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+				if(data != MAP_FAILED)
+				{
+					m_data = static_cast<const char*>(data);
+					m_size = size_t(info.st_size);
+				}
+			}
+			close(fd);
+#endif
+		}
+
+		~MappedFile()
+		{
+#ifndef _WIN32
+			if(m_data)
+				munmap(const_cast<char*>(m_data), m_size);
+#endif
+		}
+
+		const char* m_data;
+		size_t m_size;
+
+#ifdef _WIN32
+		std::vector<char> m_buffer;
+#endif
+	};
+
+	// the type each codec decodes to, which must be the type of the member the field is stored in
+	Type* field_type(StyleFieldCodec codec)
+	{
+		switch(codec)
+		{
+		case FIELD_STRING: return &cls<string>();
+		case FIELD_BOOL: return &cls<bool>();
+		case FIELD_INT: return &cls<int>();
+		case FIELD_SIZE: return &cls<size_t>();
+		case FIELD_FLOAT: return &cls<float>();
+		case FIELD_SOLVER: return &cls<LayoutSolver>();
+		case FIELD_FLOW: return &cls<Flow>();
+		case FIELD_CLIPPING: return &cls<Clipping>();
+		case FIELD_OPACITY: return &cls<Opacity>();
+		case FIELD_DIMENSION: return &cls<Dimension>();
+		case FIELD_SPACE: return &cls<Space>();
+		case FIELD_AUTOLAYOUT: return &cls<Dim<AutoLayout>>();
+		case FIELD_ALIGN: return &cls<Dim<Align>>();
+		case FIELD_PIVOT: return &cls<Dim<Pivot>>();
+		case FIELD_DIMFLOAT: return &cls<DimFloat>();
+		case FIELD_BOXFLOAT: return &cls<BoxFloat>();
+		case FIELD_COLOUR: return &cls<Colour>();
+		case FIELD_SHADOW: return &cls<Shadow>();
+		case FIELD_IMAGE: return &cls<Image>();
+		case FIELD_IMAGE_SKIN: return &cls<ImageSkin>();
+		case FIELD_STYLE: return &cls<Style>();
+		}
+
+		return nullptr;
+	}
+
+	// hashes the name and type of every member with FNV-1a, which unlike std::hash is stable across builds
+	uint32_t reflection_hash(Meta& meta)
+	{
+		uint32_t hash = 2166136261u;
+		auto combine = [&hash](const string& value)
+		{
+			for(char c : value)
+				hash = (hash ^ uint8_t(c)) * 16777619u;
+			hash = (hash ^ 0xffu) * 16777619u;
+		};
+
+		for(Member& member : meta.m_members)
+		{
+			combine(member.m_name);
+			combine(member.m_type->m_name);
+		}
+		return hash;
+	}
+
+	template <class T>
+	bool write_pod(BlobWriter& writer, Var& value, StyleFieldCodec codec)
+	{
+		if(!value.type().is<T>())
+			return false;
+		writer.pod(codec);
+		write_value(writer, value.val<T>());
+		return true;
+	}
+
+	template <class T>
+	Var read_pod(BlobReader& reader, T value)
+	{
+		read_value(reader, value);
+		return var(value);
+	}
+
+	bool write_field(BlobWriter& writer, Var& value)
+	{
+		if(write_pod<bool>(writer, value, FIELD_BOOL) || write_pod<int>(writer, value, FIELD_INT) || write_pod<size_t>(writer, value, FIELD_SIZE)
+		|| write_pod<float>(writer, value, FIELD_FLOAT) || write_pod<LayoutSolver>(writer, value, FIELD_SOLVER) || write_pod<Flow>(writer, value, FIELD_FLOW)
+		|| write_pod<Clipping>(writer, value, FIELD_CLIPPING) || write_pod<Opacity>(writer, value, FIELD_OPACITY) || write_pod<Dimension>(writer, value, FIELD_DIMENSION)
+		|| write_pod<Space>(writer, value, FIELD_SPACE) || write_pod<Dim<AutoLayout>>(writer, value, FIELD_AUTOLAYOUT) || write_pod<Dim<Align>>(writer, value, FIELD_ALIGN)
+		|| write_pod<Dim<Pivot>>(writer, value, FIELD_PIVOT) || write_pod<DimFloat>(writer, value, FIELD_DIMFLOAT))
+			return true;
+
+		if(value.type().is<string>())
+		{
+			writer.pod(FIELD_STRING);
+			writer.str(value.val<string>());
+		}
+		else if(value.type().is<BoxFloat>())
+		{
+			BoxFloat& box = value.val<BoxFloat>();
+			writer.pod(FIELD_BOXFLOAT);
+			writer.pod(box.null());
+			for(size_t i = 0; i < 4; ++i)
+				writer.pod(box[i]);
+		}
+		else if(value.type().is<Colour>())
+		{
+			writer.pod(FIELD_COLOUR);
+			writer.colour(value.val<Colour>());
+		}
+		else if(value.type().is<Shadow>())
+		{
+			Shadow& shadow = value.val<Shadow>();
+			writer.pod(FIELD_SHADOW);
+			writer.pod(shadow.d_null);
+			writer.pod(shadow.d_xpos); writer.pod(shadow.d_ypos); writer.pod(shadow.d_blur); writer.pod(shadow.d_spread);
+			writer.colour(shadow.d_colour);
+		}
+		else if(value.type().is<Image>())
+		{
+			// a null image is a null reference : it can't be dereferenced to check it
+			writer.pod(FIELD_IMAGE);
+			writer.str(value.null() ? "" : value.val<Image>().d_name);
+		}
+		else if(value.type().is<ImageSkin>())
+		{
+			ImageSkin& skin = value.val<ImageSkin>();
+			writer.pod(FIELD_IMAGE_SKIN);
+			writer.str(skin.d_image ? skin.d_image->d_name : "");
+			if(skin.d_image)
+			{
+				write_value(writer, skin.d_left); write_value(writer, skin.d_top); write_value(writer, skin.d_right); write_value(writer, skin.d_bottom);
+				write_value(writer, skin.m_margin); writer.pod(skin.d_stretch);
+			}
+		}
+		else if(value.type().is<Style>())
+		{
+			writer.pod(FIELD_STYLE);
+			writer.str(value.null() ? "" : value.val<Style>().m_name);
+		}
+		else
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	Var read_field(BlobReader& reader, StyleFieldCodec codec, UiWindow& uiWindow)
+	{
+		switch(codec)
+		{
+		case FIELD_STRING: return var(reader.str());
+		case FIELD_BOOL: return read_pod<bool>(reader, false);
+		case FIELD_INT: return read_pod<int>(reader, 0);
+		case FIELD_SIZE: return read_pod<size_t>(reader, 0);
+		case FIELD_FLOAT: return read_pod<float>(reader, 0.f);
+		case FIELD_SOLVER: return read_pod<LayoutSolver>(reader, FRAME_SOLVER);
+		case FIELD_FLOW: return read_pod<Flow>(reader, FLOW);
+		case FIELD_CLIPPING: return read_pod<Clipping>(reader, NOCLIP);
+		case FIELD_OPACITY: return read_pod<Opacity>(reader, CLEAR);
+		case FIELD_DIMENSION: return read_pod<Dimension>(reader, DIM_NULL);
+		case FIELD_SPACE: return read_pod<Space>(reader, Space::preset(SHEET));
+		case FIELD_AUTOLAYOUT: return read_pod<Dim<AutoLayout>>(reader, Dim<AutoLayout>(AUTO_LAYOUT, AUTO_LAYOUT));
+		case FIELD_ALIGN: return read_pod<Dim<Align>>(reader, Dim<Align>(LEFT, LEFT));
+		case FIELD_PIVOT: return read_pod<Dim<Pivot>>(reader, Dim<Pivot>(FORWARD, FORWARD));
+		case FIELD_DIMFLOAT: return read_pod<DimFloat>(reader, DimFloat(0.f, 0.f));
+		case FIELD_BOXFLOAT:
+		{
+			bool null = reader.pod<bool>();
+			BoxFloat box;
+			for(size_t i = 0; i < 4; ++i)
+				box[i] = reader.pod<float>();
+			if(null)
+				box.clear();
+			return var(box);
+		}
+		case FIELD_COLOUR: return var(reader.colour());
+		case FIELD_SHADOW:
+		{
+			bool null = reader.pod<bool>();
+			float xpos = reader.pod<float>(); float ypos = reader.pod<float>(); float blur = reader.pod<float>(); float spread = reader.pod<float>();
+			Colour colour = reader.colour();
+			return null ? var(Shadow()) : var(Shadow(xpos, ypos, blur, spread, colour));
+		}
+		case FIELD_IMAGE:
+		{
+			string name = reader.str();
+			return Ref(name.empty() ? (Image*) nullptr : &uiWindow.findImage(name));
+		}
+		case FIELD_IMAGE_SKIN:
+		{
+			string name = reader.str();
+			if(name.empty())
+				return var(ImageSkin());
+			int left, top, right, bottom, margin;
+			read_value(reader, left); read_value(reader, top); read_value(reader, right); read_value(reader, bottom);
+			read_value(reader, margin); Dimension stretch = reader.pod<Dimension>();
+			return var(ImageSkin(uiWindow.findImage(name), left, top, right, bottom, margin, stretch));
+		}
+		case FIELD_STYLE:
+		{
+			string name = reader.str();
+			if(name.empty())
+				return Ref((Style*) nullptr);
+			Style* style = StyleRegistry::find(name);
+			if(style)
+				return Ref(style);
+			printf("ERROR: Compiled style sheet references unknown style %s\n", name.c_str());
+			return Var();
+		}
+		}
+
+		reader.m_error = true;
+		return Var();
+	}
+
+	bool pack_style_value(Var& value, string& packed)
+	{
+		BlobWriter writer;
+		bool success = write_field(writer, value);
+		packed = std::move(writer.m_data);
+		return success;
+	}
+
+	void write_definitions(BlobWriter& writer, std::map<string, Options>& definitions, StyleDefinitionKind kind, uint32_t& count, bool& success)
+	{
+		for(auto& kv : definitions)
+		{
+			uint32_t fields = 0;
+			for(Var& value : kv.second.m_fields)
+				if(!value.none())
+					++fields;
+			if(fields == 0)
+				continue;
+
+			writer.str(kv.first);
+			writer.pod(kind);
+			writer.pod(fields);
+
+			for(size_t i = 0; i < kv.second.m_fields.size(); ++i)
+			{
+				Var& value = kv.second.m_fields[i];
+				if(value.none())
+					continue;
+
+				writer.pod(uint16_t(i));
+				if(!write_field(writer, value))
+				{
+					printf("ERROR: Style field %i of %s can't be compiled\n", int(i), kv.first.c_str());
+					success = false;
+					return;
+				}
+			}
+
+			++count;
+		}
+	}
+
+	bool compile_style_sheet(Styler& styler, const string& path, const string& output)
+	{
+		std::map<string, Options> layout_definitions;
+		std::map<string, Options> skin_definitions;
+		std::swap(layout_definitions, styler.m_layout_definitions);
+		std::swap(skin_definitions, styler.m_skin_definitions);
+
+		load_style_sheet(styler, path);
+
+		BlobWriter writer;
+		uint32_t count = 0;
+		bool success = true;
+		write_definitions(writer, styler.m_layout_definitions, LAYOUT_DEFINITION, count, success);
+		if(success)
+			write_definitions(writer, styler.m_skin_definitions, SKIN_DEFINITION, count, success);
+
+		std::swap(layout_definitions, styler.m_layout_definitions);
+		std::swap(skin_definitions, styler.m_skin_definitions);
+
+		if(!success)
+			return false;
+
+		BlobWriter header;
+		header.m_data.append(c_styleBlobMagic, 4);
+		header.pod(c_styleBlobVersion);
+		header.pod(reflection_hash(meta<Layout>()));
+		header.pod(reflection_hash(meta<InkStyle>()));
+		header.pod(count);
+
+		std::ofstream file(output, std::ios::binary);
+		if(!file)
+		{
+			printf("ERROR: Could not write compiled style sheet %s\n", output.c_str());
+			return false;
+		}
+
+		file.write(header.m_data.data(), header.m_data.size());
+		file.write(writer.m_data.data(), writer.m_data.size());
+		return bool(file);
+	}
+
+	bool load_compiled_style_sheet(Styler& styler, const string& path)
+	{
+		MappedFile file(path);
+		if(!file.m_data)
+		{
+			printf("ERROR: Could not open compiled style sheet %s\n", path.c_str());
+			return false;
+		}
+
+		BlobReader reader(file.m_data, file.m_size);
+
+		char magic[4] = {};
+		for(char& c : magic)
+			reader.pod(c);
+		uint32_t version = reader.pod<uint32_t>();
+		uint32_t layoutHash = reader.pod<uint32_t>();
+		uint32_t skinHash = reader.pod<uint32_t>();
+		uint32_t count = reader.pod<uint32_t>();
+
+		// the blob stores members by index : it is only valid for the reflection data it was compiled against
+		if(reader.m_error || memcmp(magic, c_styleBlobMagic, 4) != 0 || version != c_styleBlobVersion
+		|| layoutHash != reflection_hash(meta<Layout>()) || skinHash != reflection_hash(meta<InkStyle>()))
+		{
+			printf("ERROR: Compiled style sheet %s is stale or invalid, recompile it\n", path.c_str());
+			return false;
+		}
+
+		for(uint32_t d = 0; d < count && !reader.m_error; ++d)
+		{
+			string name = reader.str();
+			StyleDefinitionKind kind = reader.pod<StyleDefinitionKind>();
+			uint32_t fields = reader.pod<uint32_t>();
+
+			Options& definition = kind == LAYOUT_DEFINITION ? styler.m_layout_definitions[name] : styler.m_skin_definitions[name];
+			Meta& reflection = kind == LAYOUT_DEFINITION ? meta<Layout>() : meta<InkStyle>();
+
+			for(uint32_t f = 0; f < fields && !reader.m_error; ++f)
+			{
+				uint16_t index = reader.pod<uint16_t>();
+				StyleFieldCodec codec = reader.pod<StyleFieldCodec>();
+				if(index >= reflection.m_members.size() || field_type(codec) != reflection.m_members[index].m_type)
+				{
+					reader.m_error = true;
+					break;
+				}
+
+				Var value = read_field(reader, codec, styler.m_uiWindow);
+				if(!value.none())
+					definition.set(index, value);
+			}
+		}
+
+		if(reader.m_error)
+		{
+			printf("ERROR: Compiled style sheet %s is truncated or corrupt\n", path.c_str());
+			return false;
+		}
+
+		return true;
+	}
+
+	bool set_compiled_style_sheet(Styler& styler, const string& path)
+	{
+		styler.clear();
+
+		bool loaded = load_compiled_style_sheet(styler, path);
+		if(!loaded)
+			styler.clear();
+
+		styler.setup();
+		return loaded;
+	}
+}
@@ -0,0 +1,23 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#ifndef TOY_STYLECOMPILER_H
+#define TOY_STYLECOMPILER_H
+
+/* toy */
+#include <toyui/Types.h>
+
+namespace toy
+{
+	// A compiled style sheet is a versioned binary blob of the layout and skin definitions of a style sheet and its includes :
+	// colours are substituted and values unpacked once, so applying it is a single pass over a memory mapped file, without any parsing or reflection lookup by name
+	TOY_UI_EXPORT bool compile_style_sheet(Styler& styler, const string& path, const string& output);
+	TOY_UI_EXPORT bool load_compiled_style_sheet(Styler& styler, const string& path);
+	TOY_UI_EXPORT bool set_compiled_style_sheet(Styler& styler, const string& path);
+
+	// packs a single definition value in its compiled form : two values are equal when their packed bytes are
+	TOY_UI_EXPORT bool pack_style_value(Var& value, string& packed);
+}
+
+#endif // TOY_STYLECOMPILER_H
@@ -12,6 +12,12 @@
 #include <toyui/Style/Style.h>
 #include <toyui/UiLayout.h>
 #include <toyui/UiWindow.h>
+#include <toyui/Log.h>
+
+/* std */
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
 
 namespace toy
 {
@@ -69,11 +75,36 @@ namespace toy
 		return unpacker;
 	}
 
+	void replace_colours(const std::map<string, Colour>& colours, json& json_value)
+	{
+		visit_json(json_value, [&](json& json_value)
+		{
+			if(json_value.is_string() && colours.find(json_value.get<string>()) != colours.end())
+				json_value = colours.at(json_value.get<string>());
+		});
+	}
+
+	void load_colours(std::map<string, Colour>& colours, const json& json_colours)
+	{
+		for(json::const_iterator colour_it = json_colours.begin(); colour_it != json_colours.end(); ++colour_it)
+			colours[colour_it.key()] = colour_it.value();
+	}
+
 	void load_member(Styler& styler, Options& definition, Member& member, const json& json_value)
 	{
 		static FromJson unpacker = style_unpacker(styler.m_uiWindow);
-		Var value = unpack(unpacker, *member.m_type, json_value);
-		definition.set(member.m_index, value);
+
+		// a palette colour set directly on a field stays symbolic, so that switching palettes only patches the field
+		if(json_value.is_string() && styler.m_palette.find(json_value.get<string>()) != styler.m_palette.end())
+		{
+			string variable = json_value.get<string>();
+			definition.bind(member.m_index, variable, var(styler.m_palette[variable]));
+			return;
+		}
+
+		json value = json_value;
+		replace_colours(styler.m_palette, value);
+		definition.set(member.m_index, unpack(unpacker, *member.m_type, value));
 	}
 
 	void load_style_attr(Styler& styler, const string& style, Options& layout_def, Options& skin_def, string key, const json& json_value)
@@ -115,32 +146,218 @@ namespace toy
 		}
 	}
 
-	void replace_colours(const std::map<string, Colour>& colours, json& json_value)
+	// Streaming parser for the indentation based style sheets in data/interface/styles :
+	// top level lines open a style block, indented lines hold attributes or open a state block, state blocks hold attributes
+	// attributes are fed to load_style_attr as they are read, with scalar and comma separated values converted on the fly
+	class YamlStyleParser
 	{
-		visit_json(json_value, [&](json& json_value)
+	public:
+		YamlStyleParser(Styler& styler, const string& path, const string& text)
+			: m_styler(styler), m_path(path), m_cursor(text.data()), m_end(text.data() + text.size()), m_line(0)
+		{}
+
+		bool parse()
 		{
-			if(json_value.is_string() && colours.find(json_value.get<string>()) != colours.end())
-				json_value = colours.at(json_value.get<string>());
-		});
-	}
+			while(m_cursor < m_end)
+			{
+				const char* begin = m_cursor;
+				const char* end = begin;
+				while(end < m_end && *end != '\n') ++end;
+				m_cursor = end < m_end ? end + 1 : end;
+				++m_line;
 
-	void load_colours(std::map<string, Colour>& colours, const json& json_colours)
+				if(end > begin && end[-1] == '\r') --end;
+				if(!this->parseLine(begin, end))
+					return false;
+			}
+			return true;
+		}
+
+	protected:
+		static bool blank(char c) { return c == ' ' || c == '\t'; }
+
+		static void trim(const char*& begin, const char*& end)
+		{
+			while(begin < end && blank(*begin)) ++begin;
+			while(end > begin && blank(end[-1])) --end;
+		}
+
+		bool error(const char* at, const char* begin, const char* message)
+		{
+			Log::print(LOG_ERROR, "%s:%i:%i: %s\n", m_path.c_str(), int(m_line), int(at - begin) + 1, message);
+			return false;
+		}
+
+		bool parseLine(const char* begin, const char* end)
+		{
+			const char* content = begin;
+			while(content < end && *content == ' ') ++content;
+
+			const char* visible = content;
+			while(visible < end && blank(*visible)) ++visible;
+			if(visible == end || *visible == '#')
+				return true;
+			if(content != visible)
+				return this->error(content, begin, "tabs are not allowed for indentation");
+
+			size_t indent = content - begin;
+
+			const char* colon = content;
+			while(colon < end && *colon != ':') ++colon;
+			if(colon == end)
+				return this->error(end, begin, "expected ':' after key");
+
+			const char* keyBegin = content; const char* keyEnd = colon;
+			const char* valueBegin = colon + 1; const char* valueEnd = end;
+			trim(keyBegin, keyEnd);
+			trim(valueBegin, valueEnd);
+			if(keyBegin == keyEnd)
+				return this->error(content, begin, "empty key");
+
+			string key(keyBegin, keyEnd);
+			bool block = valueBegin == valueEnd;
+
+			// each open block remembers its indentation : a line closes every block indented as much or more than itself
+			if(indent == 0)
+				m_indents.clear();
+			else if(m_indents.empty())
+				return this->error(content, begin, "attribute outside of a style block");
+			while(!m_indents.empty() && m_indents.back() >= indent)
+				m_indents.pop_back();
+			m_indents.push_back(indent);
+			size_t depth = m_indents.size() - 1;
+
+			if(depth == 0)
+			{
+				if(!block)
+					return this->error(valueBegin, begin, "expected a style block");
+				m_styles = splitString(replaceAll(key, " ", ""), ",");
+				m_states.clear();
+				return true;
+			}
+
+			if(m_styles.empty())
+				return this->error(content, begin, "attribute outside of a style block");
+
+			if(depth == 1 && block)
+			{
+				m_states = splitString(replaceAll(key, " ", ""), ",");
+				return true;
+			}
+			else if(depth == 1)
+			{
+				m_states.clear();
+			}
+			else if(depth > 2 || block || m_states.empty())
+			{
+				return this->error(content, begin, "style blocks can only be nested one level deep");
+			}
+
+			json value = parseValue(valueBegin, valueEnd);
+			for(const string& style : m_styles)
+			{
+				if(m_states.empty())
+					this->loadAttr(style, key, value, keyBegin, begin);
+				else
+					for(const string& state : m_states)
+						this->loadAttr(style + ":" + state, key, value, keyBegin, begin);
+			}
+			return true;
+		}
+
+		static json parseScalar(const char* begin, const char* end)
+		{
+			trim(begin, end);
+			string token(begin, end);
+			if(token == "true" || token == "false")
+				return token == "true";
+
+			char* parsed = nullptr;
+			double number = strtod(token.c_str(), &parsed);
+			if(!token.empty() && parsed == token.c_str() + token.size())
+				return number;
+			return token;
+		}
+
+		static json parseValue(const char* begin, const char* end)
+		{
+			const char* comma = begin;
+			while(comma < end && *comma != ',') ++comma;
+			if(comma == end)
+				return parseScalar(begin, end);
+
+			json values = json::array();
+			while(begin <= end)
+			{
+				comma = begin;
+				while(comma < end && *comma != ',') ++comma;
+				values.push_back(parseScalar(begin, comma));
+				begin = comma + 1;
+			}
+			return values;
+		}
+
+		void loadAttr(const string& style, const string& key, const json& value, const char* at, const char* line)
+		{
+			Options& layout_def = m_styler.m_layout_definitions[style];
+			Options& skin_def = m_styler.m_skin_definitions[style];
+
+			if(key == "inherit")
+			{
+				layout_def.merge(m_styler.m_layout_definitions[value.get<string>()]);
+				skin_def.merge(m_styler.m_skin_definitions[value.get<string>()]);
+			}
+			else if(key == "topdown_gradient")
+				load_style_attr(m_styler, style, layout_def, skin_def, "linear_gradient", value);
+			else if(key == "decline_image" || key == "decline_image_skin")
+				decline(m_styler, style, skin_def, value.is_array() ? value : json::array({ value }));
+			else if(key == "copy_skin" || key == "reset_skin" || meta<Layout>().hasMember(key) || meta<InkStyle>().hasMember(replaceAll(key, "skin_", "")))
+				load_style_attr(m_styler, style, layout_def, skin_def, key, value);
+			else
+				Log::print(LOG_WARNING, "%s:%i:%i: unsupported style attribute %s\n", m_path.c_str(), int(m_line), int(at - line) + 1, key.c_str());
+		}
+
+		Styler& m_styler;
+		const string& m_path;
+		const char* m_cursor;
+		const char* m_end;
+		size_t m_line;
+
+		std::vector<size_t> m_indents;
+		std::vector<string> m_styles;
+		std::vector<string> m_states;
+	};
+
+	bool load_yaml_style_sheet(Styler& styler, const string& path)
 	{
-		for(json::const_iterator colour_it = json_colours.begin(); colour_it != json_colours.end(); ++colour_it)
-			colours[colour_it.key()] = colour_it.value();
+		std::ifstream file(path, std::ios::binary);
+		if(!file)
+		{
+			Log::print(LOG_ERROR, "Could not open style sheet %s\n", path.c_str());
+			return false;
+		}
+
+		string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		YamlStyleParser parser(styler, path, text);
+		return parser.parse();
 	}
 
 	void load_style_sheet(Styler& styler, const string& path)
 	{
+		if(path.size() > 4 && path.compare(path.size() - 4, 4, ".yml") == 0)
+		{
+			load_yaml_style_sheet(styler, path);
+			return;
+		}
+
 		json style_sheet = parse_json_file(path);
 
 		json includes = style_sheet["includes"];
 		for(json::const_iterator style_it = includes.begin(); style_it != includes.end(); ++style_it)
 			load_style_sheet(styler, styler.m_uiWindow.m_resourcePath + "interface/styles/" + style_it->get<string>());
 
-		std::map<string, Colour> colours;
-		load_colours(colours, style_sheet["colours"]);
-		replace_colours(colours, style_sheet["styles"]);
+		load_colours(styler.m_palette, style_sheet["colours"]);
 
 		json styles = style_sheet["styles"];
 		for(json::const_iterator style_it = styles.begin(); style_it != styles.end(); ++style_it)
@@ -156,6 +373,21 @@ namespace toy
 		styler.setup();
 	}
 
+	void reload_style_sheet(Styler& styler, const string& path)
+	{
+		std::map<string, Options> layout_definitions;
+		std::map<string, Options> skin_definitions;
+		std::swap(layout_definitions, styler.m_layout_definitions);
+		std::swap(skin_definitions, styler.m_skin_definitions);
+
+		load_style_sheet(styler, path);
+
+		std::swap(layout_definitions, styler.m_layout_definitions);
+		std::swap(skin_definitions, styler.m_skin_definitions);
+
+		styler.reload(layout_definitions, skin_definitions);
+	}
+
 	void set_default_style_sheet(Styler& styler)
 	{
 		styler.clear();
@@ -13,6 +13,9 @@ namespace toy
 	TOY_UI_EXPORT void load_style_sheet(Styler& styler, const string& path);
 	TOY_UI_EXPORT void set_style_sheet(Styler& styler, const string& path);
 	TOY_UI_EXPORT void set_default_style_sheet(Styler& styler);
+
+	// reloads the style sheet in place : only the widgets whose styles changed are restyled, as lightly as the change allows
+	TOY_UI_EXPORT void reload_style_sheet(Styler& styler, const string& path);
 }
 
 #endif // TOY_STYLEPARSER_H
@@ -0,0 +1,159 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#include <toyui/Config.h>
+#include <toyui/Style/StyleTransition.h>
+
+#include <toyui/Style/Style.h>
+#include <toyui/Frame/Frame.h>
+
+namespace toy
+{
+	StyleTransitions* StyleTransitions::s_active = nullptr;
+
+	static inline float lerp(float source, float target, float t)
+	{
+		return source + (target - source) * t;
+	}
+
+	static inline Colour blend_colour(const Colour& source, const Colour& target, float t)
+	{
+		if(source.null() || target.null())
+			return target;
+		return Colour(lerp(source.m_r, target.m_r, t), lerp(source.m_g, target.m_g, t), lerp(source.m_b, target.m_b, t), lerp(source.m_a, target.m_a, t));
+	}
+
+	static inline BoxFloat blend_box(const BoxFloat& source, const BoxFloat& target, float t)
+	{
+		if(source.null() || target.null())
+			return target;
+		return BoxFloat(lerp(source[0], target[0], t), lerp(source[1], target[1], t), lerp(source[2], target[2], t), lerp(source[3], target[3], t));
+	}
+
+	StyleTransitions::StyleTransitions(float duration)
+		: m_duration(duration)
+	{}
+
+	void StyleTransitions::blend(const InkStyle& source, const InkStyle& target, float t, InkStyle& result)
+	{
+		result.m_background_colour = blend_colour(source.m_background_colour, target.m_background_colour, t);
+		result.m_border_colour = blend_colour(source.m_border_colour, target.m_border_colour, t);
+		result.m_image_colour = blend_colour(source.m_image_colour, target.m_image_colour, t);
+		result.m_text_colour = blend_colour(source.m_text_colour, target.m_text_colour, t);
+		result.m_shadow_colour = blend_colour(source.m_shadow_colour, target.m_shadow_colour, t);
+
+		result.m_corner_radius = blend_box(source.m_corner_radius, target.m_corner_radius, t);
+		result.m_linear_gradient = DimFloat(lerp(source.m_linear_gradient.x, target.m_linear_gradient.x, t), lerp(source.m_linear_gradient.y, target.m_linear_gradient.y, t));
+
+		if(!source.m_shadow.d_null && !target.m_shadow.d_null)
+		{
+			const Shadow& from = source.m_shadow;
+			const Shadow& to = target.m_shadow;
+			result.m_shadow = Shadow(lerp(from.d_xpos, to.d_xpos, t), lerp(from.d_ypos, to.d_ypos, t), lerp(from.d_blur, to.d_blur, t), lerp(from.d_spread, to.d_spread, t), blend_colour(from.d_colour, to.d_colour, t));
+		}
+	}
+
+	bool StyleTransitions::start(Frame& frame, const InkStyle& source, InkStyle& target)
+	{
+		Transition* transition = this->find(frame);
+
+		if(m_duration <= 0.f)
+		{
+			if(transition)
+				this->remove(transition - m_transitions.data());
+			return false;
+		}
+
+		if(transition && transition->m_target == &target)
+		{
+			frame.d_inkstyle = transition->m_current.get();
+			return true;
+		}
+
+		if(transition)
+		{
+			// retargeted midway : the skin currently displayed becomes the source, so that the animation doesn't jump
+			std::swap(transition->m_source, transition->m_current);
+		}
+		else
+		{
+			m_transitions.push_back({ &frame, nullptr, 0.f, this->acquire(), this->acquire() });
+			transition = &m_transitions.back();
+			*transition->m_source = source;
+		}
+
+		transition->m_target = &target;
+		transition->m_elapsed = 0.f;
+		*transition->m_current = target;
+		StyleTransitions::blend(*transition->m_source, target, 0.f, *transition->m_current);
+
+		frame.d_inkstyle = transition->m_current.get();
+		return true;
+	}
+
+	void StyleTransitions::cancel(Frame& frame)
+	{
+		Transition* transition = this->find(frame);
+		if(transition)
+			this->remove(transition - m_transitions.data());
+	}
+
+	void StyleTransitions::update(size_t delta)
+	{
+		size_t index = 0;
+		while(index < m_transitions.size())
+		{
+			Transition& transition = m_transitions[index];
+			transition.m_elapsed += float(delta);
+
+			if(transition.m_elapsed >= m_duration)
+			{
+				transition.m_frame->d_inkstyle = transition.m_target;
+				transition.m_frame->markRepaint();
+				this->remove(index);
+				continue;
+			}
+
+			float t = transition.m_elapsed / m_duration;
+			StyleTransitions::blend(*transition.m_source, *transition.m_target, t * t * (3.f - 2.f * t), *transition.m_current);
+			transition.m_frame->markRepaint();
+			++index;
+		}
+	}
+
+	void StyleTransitions::targets(std::unordered_set<const InkStyle*>& skins) const
+	{
+		for(const Transition& transition : m_transitions)
+			skins.insert(transition.m_target);
+	}
+
+	StyleTransitions::Transition* StyleTransitions::find(Frame& frame)
+	{
+		for(Transition& transition : m_transitions)
+			if(transition.m_frame == &frame)
+				return &transition;
+		return nullptr;
+	}
+
+	void StyleTransitions::remove(size_t index)
+	{
+		Transition& transition = m_transitions[index];
+		m_spare.push_back(std::move(transition.m_source));
+		m_spare.push_back(std::move(transition.m_current));
+
+		if(index != m_transitions.size() - 1)
+			transition = std::move(m_transitions.back());
+		m_transitions.pop_back();
+	}
+
+	std::unique_ptr<InkStyle> StyleTransitions::acquire()
+	{
+		if(m_spare.empty())
+			return make_unique<InkStyle>();
+
+		std::unique_ptr<InkStyle> skin = std::move(m_spare.back());
+		m_spare.pop_back();
+		return skin;
+	}
+}
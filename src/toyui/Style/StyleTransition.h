@@ -0,0 +1,65 @@
+//  Copyright (c) 2016 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#ifndef TOY_STYLETRANSITION_H
+#define TOY_STYLETRANSITION_H
+
+/* toy */
+#include <toyobj/Util/NonCopy.h>
+#include <toyui/Types.h>
+
+/* std */
+#include <memory>
+#include <vector>
+#include <unordered_set>
+
+namespace toy
+{
+	// Animates paint only skin changes (colours, gradient, shadow, corner radius) over a fixed duration instead of snapping
+	// While animating, the frame points to a skin owned by the transition : each step only repaints the owning layer, and costs nothing once no transition is active
+	class TOY_UI_EXPORT StyleTransitions : public NonCopy
+	{
+	public:
+		struct Transition
+		{
+			Frame* m_frame;
+			InkStyle* m_target;
+			float m_elapsed;
+			std::unique_ptr<InkStyle> m_source;
+			std::unique_ptr<InkStyle> m_current;
+		};
+
+		StyleTransitions(float duration = 0.f);
+
+		// starts animating the frame from the source skin to the target one, returns false if transitions are disabled
+		bool start(Frame& frame, const InkStyle& source, InkStyle& target);
+		void cancel(Frame& frame);
+
+		// delta is the frame time step, in milliseconds
+		void update(size_t delta);
+
+		size_t active() const { return m_transitions.size(); }
+
+		// adds the skins the running transitions animate towards, which must stay alive until they complete
+		void targets(std::unordered_set<const InkStyle*>& skins) const;
+
+		static void blend(const InkStyle& source, const InkStyle& target, float t, InkStyle& result);
+
+		// duration of a transition in milliseconds, 0 snaps to the target skin immediately
+		float m_duration;
+
+		static StyleTransitions* s_active;
+
+	protected:
+		Transition* find(Frame& frame);
+		void remove(size_t index);
+
+		std::unique_ptr<InkStyle> acquire();
+
+		std::vector<Transition> m_transitions;
+		std::vector<std::unique_ptr<InkStyle>> m_spare;
+	};
+}
+
+#endif // TOY_STYLETRANSITION_H
@@ -6,50 +6,274 @@
 #include <toyui/UiLayout.h>
 
 #include <toyui/UiWindow.h>
+#include <toyui/Style/StyleTransition.h>
 
 #include <toyui/Bundle.h>
+#include <toyui/Log.h>
+
+#include <toyobj/Reflect/Meta.h>
+#include <toyui/Generated/Meta.h>
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <set>
 
 namespace toy
 {
 	Styler::Styler(UiWindow& uiWindow)
 		: m_uiWindow(uiWindow)
+		, m_watchTime(0)
+		, m_watchFrame(0)
 	{
+		// the styles of each module are only declared when the module is first used
 		Widget::styles();
-		Cursor::styles();
-		Scrollbar::styles();
-		Dropdown::styles();
-		Expandbox::styles();
-		TreeNode::styles();
-		Tabber::styles();
-		Menu::styles();
-		Toolbar::styles();
-		Window::styles();
-		Dockspace::styles();
-		Dockbar::styles();
-		Canvas::styles();
-		Node::styles();
-		Directory::styles();
+
+		StyleRegistry::declare({ &cls<Dropdown>(), &cls<DropdownInput>(), &cls<TypedownInput>() }, [] { Dropdown::styles(); });
+		StyleRegistry::declare({ &cls<Expandbox>() }, [] { Expandbox::styles(); });
+		StyleRegistry::declare({ &cls<TreeNode>() }, [] { TreeNode::styles(); });
+		StyleRegistry::declare({ &cls<Tab>(), &cls<Tabber>() }, [] { Tabber::styles(); });
+		StyleRegistry::declare({ &cls<Menubar>(), &cls<Menu>() }, [] { Menu::styles(); });
+		StyleRegistry::declare({ &cls<ToolButton>(), &cls<Tooldock>(), &cls<Toolbar>() }, [] { Toolbar::styles(); });
+		StyleRegistry::declare({ &cls<Window>(), &cls<WindowHeader>(), &cls<WindowFooter>(), &cls<WindowSizer>() }, [] { Window::styles(); });
+		StyleRegistry::declare({ &cls<Dockline>(), &cls<Dockspace>() }, [] { Dockspace::styles(); });
+		StyleRegistry::declare({ &cls<Dockbar>(), &cls<Dockbox>() }, [] { Dockbar::styles(); });
+		StyleRegistry::declare({ &cls<Canvas>(), &cls<Node>(), &cls<NodeKnob>(), &cls<NodePlug>(), &cls<NodeCable>(), &cls<NodeHeader>() }, [] { Canvas::styles(); Node::styles(); });
+		StyleRegistry::declare({ &cls<Dir>(), &cls<File>() }, [] { Directory::styles(); });
+	}
+
+	Styler::~Styler()
+	{
+		if(StyleIndex::s_active == m_index.get())
+			StyleIndex::s_active = nullptr;
 	}
 
 	void Styler::clear()
 	{
 		m_layout_definitions = {};
 		m_skin_definitions = {};
+		m_palette = {};
 
-		for(auto& kv : Widget::s_styles)
-			kv.second->init();
-
-		Widget::styles().setup(m_uiWindow);
+		this->reinit();
 	}
 
 	void Styler::setup()
 	{
-		for(auto& kv : Widget::s_styles)
-			kv.second->load(m_layout_definitions, m_skin_definitions);
+		this->define();
 
 		m_uiWindow.m_rootSheet->visit([](Widget& widget, bool&) {
 			widget.frame().updateStyle(true);
 		});
+
+		this->sweep();
+	}
+
+	void Styler::reinit()
+	{
+		if(StyleIndex::s_active == m_index.get())
+			StyleIndex::s_active = nullptr;
+		m_index = nullptr;
+
+		Style::reset();
+		for(Style* style : StyleRegistry::styles())
+			style->init();
+
+		Widget::styles().setup(m_uiWindow);
+	}
+
+	void Styler::define()
+	{
+		// styles are loaded from the index the first time a frame uses them
+		m_index = make_unique<StyleIndex>(m_layout_definitions, m_skin_definitions);
+		StyleIndex::s_active = m_index.get();
+	}
+
+	void Styler::sweep()
+	{
+		// skins are only released once no style table, frame or transition refers to them anymore
+		std::unordered_set<const InkStyle*> live;
+		for(Style* style : StyleRegistry::styles())
+			live.insert(style->m_skinTable.begin(), style->m_skinTable.end());
+
+		m_uiWindow.m_rootSheet->visit([&](Widget& widget, bool&) {
+			live.insert(widget.frame().d_inkstyle);
+		});
+
+		if(StyleTransitions::s_active)
+			StyleTransitions::s_active->targets(live);
+
+		size_t released = InkStylePool::sweep(live);
+		if(released)
+			Log::print(LOG_DEBUG, "Released %i unused skins, %i interned\n", int(released), int(InkStylePool::size()));
+	}
+
+	static bool same_value(Var& first, Var& second)
+	{
+		if(first.none() || second.none())
+			return first.none() == second.none();
+
+		string packedFirst, packedSecond;
+		return pack_style_value(first, packedFirst) && pack_style_value(second, packedSecond) && packedFirst == packedSecond;
+	}
+
+	using DefinitionChanged = std::function<void(const string&, size_t)>;
+
+	static void diff_definition(const string& name, Options* first, Options* second, const DefinitionChanged& changed)
+	{
+		Var none;
+		size_t size = std::max(first ? first->m_fields.size() : 0, second ? second->m_fields.size() : 0);
+		for(size_t i = 0; i < size; ++i)
+		{
+			Var& before = first && i < first->m_fields.size() ? first->m_fields[i] : none;
+			Var& after = second && i < second->m_fields.size() ? second->m_fields[i] : none;
+			if(!same_value(before, after))
+				changed(name, i);
+		}
+	}
+
+	static void diff_definitions(std::map<string, Options>& current, std::map<string, Options>& next, const DefinitionChanged& changed)
+	{
+		for(auto& kv : current)
+		{
+			auto it = next.find(kv.first);
+			diff_definition(kv.first, &kv.second, it != next.end() ? &(*it).second : nullptr, changed);
+		}
+
+		for(auto& kv : next)
+			if(current.find(kv.first) == current.end())
+				diff_definition(kv.first, nullptr, &kv.second, changed);
+	}
+
+	void Styler::reload(std::map<string, Options>& layout_definitions, std::map<string, Options>& skin_definitions)
+	{
+		// definitions are keyed by style name, optionally followed by a state selector
+		std::map<string, unsigned int> changes;
+		auto style_name = [](const string& key) { return key.substr(0, key.find(':')); };
+
+		size_t solver = meta<Layout>().member("solver").m_index;
+		size_t space = meta<Layout>().member("space").m_index;
+
+		diff_definitions(m_layout_definitions, layout_definitions, [&](const string& name, size_t index) {
+			changes[style_name(name)] |= (index == solver || index == space) ? STYLE_STRUCTURE : STYLE_LAYOUT;
+		});
+		diff_definitions(m_skin_definitions, skin_definitions, [&](const string& name, size_t index) {
+			UNUSED(index);
+			changes[style_name(name)] |= STYLE_SKIN;
+		});
+
+		std::swap(m_layout_definitions, layout_definitions);
+		std::swap(m_skin_definitions, skin_definitions);
+
+		if(changes.empty())
+			return;
+
+		// derived styles copy the layout their base is declared with in code, never its sheet definition : a change only affects the style it names
+		std::map<Style*, StyleChange> styleChanges;
+		for(auto& kv : changes)
+		{
+			Style* style = StyleRegistry::find(StyleRegistry::id(kv.first));
+			if(style)
+				styleChanges[style] = StyleChange(kv.second);
+		}
+
+		// only the changed styles are restored and loaded again from the new index, the others keep their skins
+		this->define();
+		for(auto& kv : styleChanges)
+			kv.first->redefine();
+
+		m_uiWindow.m_rootSheet->visit([&](Widget& widget, bool&) {
+			Frame& frame = widget.frame();
+			if(!frame.d_style || !frame.d_inkstyle)
+				return;
+
+			auto it = styleChanges.find(frame.d_style);
+			if(it == styleChanges.end())
+				return;
+
+			// frames point to interned skins, which outlive the redefinition of their style
+			frame.reloadStyle(*frame.d_inkstyle, (*it).second);
+		});
+
+		this->sweep();
+
+		Log::print(LOG_INFO, "Reloaded style sheet, %i styles changed\n", int(styleChanges.size()));
+	}
+
+	void Styler::setPalette(const std::map<string, Colour>& palette)
+	{
+		std::set<string> changed;
+		for(auto& kv : palette)
+		{
+			auto it = m_palette.find(kv.first);
+			if(it != m_palette.end() && (*it).second.m_r == kv.second.m_r && (*it).second.m_g == kv.second.m_g && (*it).second.m_b == kv.second.m_b && (*it).second.m_a == kv.second.m_a)
+				continue;
+			m_palette[kv.first] = kv.second;
+			changed.insert(kv.first);
+		}
+
+		if(changed.empty())
+			return;
+
+		// patch the bound fields in the definitions, which styles loaded later will read
+		std::set<Style*> styles;
+		for(auto& kv : m_skin_definitions)
+		{
+			bool patched = false;
+			for(auto& variable : kv.second.m_variables)
+				if(changed.find(variable.second) != changed.end())
+				{
+					kv.second.m_fields[variable.first] = var(m_palette[variable.second]);
+					patched = true;
+				}
+
+			Style* style = patched ? StyleRegistry::find(StyleRegistry::id(kv.first.substr(0, kv.first.find(':')))) : nullptr;
+			if(style && style->m_defined)
+				styles.insert(style);
+		}
+
+		if(styles.empty() || !m_index)
+			return;
+
+		// defining a loaded style again only writes the fields over its skins : layouts and solvers are left alone
+		for(Style* style : styles)
+		{
+			style->define(*style, *m_index);
+			style->m_skin.prepare();
+			for(InkStyle& skin : style->m_skins)
+				skin.prepare();
+			style->updateSkinTable();
+		}
+
+		m_uiWindow.m_rootSheet->visit([&](Widget& widget, bool&) {
+			Frame& frame = widget.frame();
+			if(frame.d_style && styles.find(frame.d_style) != styles.end())
+				frame.updateInkstyle(frame.d_style->skin(widget.m_state));
+		});
+
+		this->sweep();
+
+		Log::print(LOG_INFO, "Switched %i palette colours, %i styles patched\n", int(changed.size()), int(styles.size()));
+	}
+
+	void Styler::watch(const string& path)
+	{
+		struct stat info;
+		m_watchPath = path;
+		m_watchTime = stat(path.c_str(), &info) == 0 ? info.st_mtime : 0;
+	}
+
+	void Styler::nextFrame()
+	{
+		const size_t pollFrames = 30;
+		if(m_watchPath.empty() || ++m_watchFrame % pollFrames != 0)
+			return;
+
+		struct stat info;
+		if(stat(m_watchPath.c_str(), &info) != 0 || info.st_mtime == m_watchTime)
+			return;
+
+		m_watchTime = info.st_mtime;
+		reload_style_sheet(*this, m_watchPath);
 	}
 
 	Styles::Styles()
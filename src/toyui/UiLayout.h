@@ -14,6 +14,8 @@
 
 /* standard */
 #include <map>
+#include <memory>
+#include <ctime>
 
 namespace toy
 {
@@ -21,13 +23,36 @@ namespace toy
 	{
 	public:
 		Styler(UiWindow& uiWindow);
+		~Styler();
 
 		UiWindow& m_uiWindow;
 		std::map<string, Options> m_layout_definitions;
 		std::map<string, Options> m_skin_definitions;
+		std::map<string, Colour> m_palette;
 
 		void clear();
 		void setup();
+
+		// swaps in new definitions, restyling only the widgets whose styles changed
+		void reload(std::map<string, Options>& layout_definitions, std::map<string, Options>& skin_definitions);
+
+		// switches the named palette colours : only the skin fields bound to them are patched, and the widgets using them repainted
+		void setPalette(const std::map<string, Colour>& palette);
+
+		// polls the style sheet for modifications and hot reloads it
+		void watch(const string& path);
+		void nextFrame();
+
+	protected:
+		void reinit();
+		void define();
+		void sweep();
+
+		std::unique_ptr<StyleIndex> m_index;
+
+		string m_watchPath;
+		time_t m_watchTime;
+		size_t m_watchFrame;
 	};
 }
 
@@ -51,6 +51,7 @@ namespace toy
 		, m_renderWindow(*m_context->m_renderWindow)
 		, m_images()
 		, m_atlas(1024, 1024)
+		, m_indexedImages(0)
 		, m_width(m_renderWindow.m_width)
 		, m_height(m_renderWindow.m_height)
 		, m_styler(make_object<Styler>(*this))
@@ -127,15 +128,20 @@ namespace toy
 
 	void UiWindow::removeImage(Image& image)
 	{
-		vector_remove_if(m_images, [&](object_ptr<Image>& current) { return current->d_index == image.d_index; });
 		m_renderer->unloadImage(image);
+		m_imageIndex.clear();
+		m_indexedImages = 0;
+		vector_remove_if(m_images, [&](object_ptr<Image>& current) { return current->d_index == image.d_index; });
 	}
 
 	Image& UiWindow::findImage(const string& name)
 	{
-		for(auto& image : m_images)
-			if(image->d_name == name)
-				return *image;
+		for(; m_indexedImages < m_images.size(); ++m_indexedImages)
+			m_imageIndex.emplace(m_images[m_indexedImages]->d_name, m_images[m_indexedImages].get());
+
+		auto it = m_imageIndex.find(name);
+		if(it != m_imageIndex.end())
+			return *(*it).second;
 		static Image null; return null;
 	}
 
@@ -163,11 +169,19 @@ namespace toy
 
 		bool pursue = !m_shutdownRequested;
 		pursue &= m_context->m_renderWindow->nextFrame();
+
+		// the render window has presented the frame laid out after the last input was drained
+		m_inputLatency.presented();
+
 		pursue &= m_context->m_inputWindow->nextFrame();
 
+		m_context->m_inputWindow->m_queue.drain(m_rootSheet->m_mouse, m_rootSheet->m_keyboard, &m_inputLatency);
+
 		size_t tick = m_clock.readTick();
 		size_t delta = m_clock.stepTick();
 
+		m_styler->nextFrame();
+
 		m_rootSheet->nextFrame(tick, delta);
 
 		return pursue;
@@ -10,8 +10,10 @@
 #include <toyobj/Util/Timer.h>
 #include <toyui/Types.h>
 #include <toyui/ImageAtlas.h>
+#include <toyui/Input/InputLatency.h>
 
 #include <vector>
+#include <unordered_map>
 
 namespace toy
 {
@@ -48,6 +50,10 @@ namespace toy
 		std::vector<object_ptr<Image>> m_images;
 		ImageAtlas m_atlas;
 
+		// images hashed by name, extended lazily with the images appended since the last lookup
+		std::unordered_map<string, Image*> m_imageIndex;
+		size_t m_indexedImages;
+
 		float m_width;
 		float m_height;
 
@@ -60,6 +66,8 @@ namespace toy
 
 		Clock m_clock;
 
+		InputLatency m_inputLatency;
+
 		User* m_user;
 	};
 }
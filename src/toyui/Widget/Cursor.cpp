@@ -13,6 +13,7 @@ namespace toy
 {
 	Cursor::Cursor(RootSheet& rootSheet)
 		: Wedge({ &rootSheet, &cls<Cursor>(), LAYER })
+		, m_overlay(false)
 		, m_hovered(&rootSheet)
 		, m_locked(false)
 		, m_tooltip(rootSheet, "")
@@ -31,7 +32,19 @@ namespace toy
 		if(!m_tooltip.frame().d_hidden)
 			this->tooltipOff();
 		m_tooltipClock.step();
-		m_frame->setPosition(pos);
+
+		if(m_overlay)
+			m_frame->setOverlayPosition(pos);
+		else
+			m_frame->setPosition(pos);
+	}
+
+	void Cursor::setOverlay(bool overlay)
+	{
+		m_overlay = overlay;
+		m_frame->d_overlay = overlay;
+		m_tooltip.frame().d_overlay = overlay;
+		m_frame->markDirty(DIRTY_REDRAW);
 	}
 
 	void Cursor::tooltipOn()
@@ -51,7 +64,9 @@ namespace toy
 	{
 		if(m_locked) return;
 		m_hovered = &widget;
-		this->setStyle(widget.m_style->m_skin.m_hover_cursor ? *widget.m_style->m_skin.m_hover_cursor : styles().cursor, false);
+		Style& style = widget.m_style->m_skin.m_hover_cursor ? *widget.m_style->m_skin.m_hover_cursor : styles().cursor;
+		if(m_style != &style)
+			this->setStyle(style, false);
 	}
 
 	void Cursor::unhover(Widget& widget)
@@ -63,7 +78,8 @@ namespace toy
 	void Cursor::unhover()
 	{
 		if(m_locked) return;
-		this->setStyle(styles().cursor, false);
+		if(m_style != &styles().cursor)
+			this->setStyle(styles().cursor, false);
 		m_hovered = &this->rootSheet();
 	}
 
@@ -36,6 +36,11 @@ namespace toy
 
 		void setPosition(const DimFloat& pos);
 
+		// in overlay mode the cursor and its tooltip are drawn in a final pass over the ui : moving them doesn't dirty the widget tree
+		void setOverlay(bool overlay);
+
+		Tooltip& tooltip() { return m_tooltip; }
+
 		void hover(Widget& hovered);
 		void unhover(Widget& widget);
 		void unhover();
@@ -55,6 +60,9 @@ namespace toy
 		};
 		static Styles& styles() { static Styles styles; return styles; }
 
+	public:
+		bool m_overlay;
+
 	protected:
 		Widget* m_hovered;
 		bool m_locked;
@@ -26,17 +26,22 @@ namespace toy
 		if(!params.m_parent)
 		{
 			m_target = window.m_renderer->createRenderTarget(as<Layer>(*m_frame));
+			StyleTransitions::s_active = &m_transitions;
 			this->updateStyle();
 		}
 	}
 
 	RootSheet::~RootSheet()
-	{}
+	{
+		if(StyleTransitions::s_active == &m_transitions)
+			StyleTransitions::s_active = nullptr;
+	}
 
 	void RootSheet::nextFrame(size_t tick, size_t delta)
 	{
-		UNUSED(tick); UNUSED(delta);
+		UNUSED(tick);
 		m_cursor.update();
+		m_transitions.update(delta);
 		m_frame->relayout();
 	}
 
@@ -49,6 +54,7 @@ namespace toy
 
 		m_cursor.unhover(widget);
 		m_mouse.handleDestroyWidget(widget);
+		m_accelerators.unbind(widget);
 	}
 
 	void RootSheet::makeActive(Widget& widget)
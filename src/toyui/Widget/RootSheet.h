@@ -12,6 +12,8 @@
 #include <toyui/Widget/Cursor.h>
 #include <toyui/Input/InputDispatcher.h>
 #include <toyui/Input/InputDevice.h>
+#include <toyui/Input/Accelerators.h>
+#include <toyui/Style/StyleTransition.h>
 
 namespace toy
 {
@@ -36,6 +38,8 @@ namespace toy
 		ControlSwitch m_controller;
 		Mouse m_mouse;
 		Keyboard m_keyboard;
+		AcceleratorTable m_accelerators;
+		StyleTransitions m_transitions;
 
 		object_ptr<RenderTarget> m_target;
 
@@ -16,8 +16,6 @@
 
 namespace toy
 {
-	std::map<string, Style*> Widget::s_styles;
-
 	Widget::Widget(const Params& params)
 		: TypeObject(params.m_type ? *params.m_type : cls<Widget>())
 		, m_parent(params.m_parent)
@@ -26,6 +24,7 @@ namespace toy
 		, m_frame()
 		, m_state(NOSTATE)
 		, m_object()
+		, m_hoverStamp(0)
 	{
 		if(params.m_frameType == MASTER_LAYER || params.m_frameType == LAYER)
 			m_frame = make_object<Layer>(as<Wedge>(*this), params.m_frameType);
@@ -151,11 +150,8 @@ namespace toy
 
 	void Widget::updateStyle()
 	{
-		for(Type* type = &m_type; type && !m_style; type = type->m_base)
-			if(s_styles.find(type->m_name) != s_styles.end())
-				m_style = s_styles[type->m_name];
 		if(!m_style)
-			m_style = s_styles["Widget"];
+			m_style = StyleRegistry::typeStyle(m_type);
 		m_frame->setStyle(*m_style);
 	}
 
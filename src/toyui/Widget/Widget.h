@@ -159,8 +159,9 @@ namespace toy
 
 		Ref m_object;
 
+		size_t m_hoverStamp;
+
 		static Styles& styles() { static Styles styles; return styles; }
-		static std::map<string, Style*> s_styles;
 	};
 }
 